@@ -9,43 +9,78 @@
 #include <ViennaRNA/move_set.h>
 
 #define MINGAP 3
+#define MIN2(A, B)  ((A) < (B) ? (A) : (B))
   
 //int get_list(struct_en*, struct_en*);
-static int construct_moves_new(const char*, const short*, int , move_str **);
+static int construct_moves_new(const char*, const short*, int , move_str **, int *);
 inline int try_insert_seq2(const char*, int, int);
 inline int compat(const char, const char);
 void mtw_dump_pt(const short*);
 
 /*
-  compute a random move on a pair table
+  compute a random move on a pair table, drawn with random number
+  stream rng
   returns move operations to be applied to pt in order to perform the move
+  and stores the number of possible moves in nmoves (unless NULL);
+  the moves are collected in a buffer that is kept across calls, s.t.
+  a step does not allocate memory
  */
 move_str
-get_random_move_pt(const char *seq, const short int *pt)
+get_random_move_pt(const char *seq, const short int *pt, int *nmoves,
+		   const gsl_rng *rng)
 {
-  move_str r,*mvs=NULL;
+  static move_str *mvs=NULL;
+  static int size=0;
+  move_str r;
   int i,count;
   
-  count = construct_moves_new((const char *)seq,pt,1,&mvs);
+  count = construct_moves_new((const char *)seq,pt,0,&mvs,&size);
   /*
     for (i = 0; i<count; i++) {  
     printf("%d %d\n", mvs[i].left, mvs[i].right);
     }
   */
   
-  r.left  = mvs[0].left;
-  r.right = mvs[0].right;
-  free(mvs);
+  i = (int)gsl_rng_uniform_int(rng,count);
+  r.left  = mvs[i].left;
+  r.right = mvs[i].right;
+  if (nmoves != NULL){ *nmoves = count; }
   return r;
 }
 
+/*
+  compute all moves on a pair table (in no particular order)
+  returns the number of moves; the caller frees the move array
+ */
+int
+get_all_moves_pt(const char *seq,
+		 const short int *pt,
+		 move_str **mvs)
+{
+  int size=0;
+
+  *mvs = NULL;
+  return construct_moves_new(seq,pt,0,mvs,&size);
+}
+
 /*
   apply move operation on a pair table
+  and update its Zobrist hash (unless NULL) and
+  its base-pair distance dist to ref (unless NULL)
 */
 void
 apply_move_pt(short int *pt,
-	      move_str m)
+	      move_str m,
+	      uint64_t *hash,
+	      const short int *ref,
+	      int *dist)
 {
+  if (hash != NULL){
+    *hash ^= pair_key(abs(m.left),abs(m.right));
+  }
+  if (ref != NULL){
+    *dist += move_distance(ref,m);
+  }
   if(m.left < 0){
     pt[(int)(fabs(m.left))] = 0;
     pt[(int)(fabs(m.right))] = 0;
@@ -57,26 +92,68 @@ apply_move_pt(short int *pt,
   //print_str(stdout,pt);printf("\n");
 }
 
+/*
+  Zobrist hash of a pair table, i.e. XOR over the keys of all pairs
+*/
+uint64_t
+structure_hash_pt(const short int *pt)
+{
+  int i;
+  uint64_t hash = 0;
+
+  for(i=1;i<=pt[0];i++){
+    if (pt[i] > i){ hash ^= pair_key(i,pt[i]); }
+  }
+  return hash;
+}
+
+/*
+  base-pair distance, i.e. # of pairs in exactly one of a and b
+*/
+int
+bp_distance_pt(const short int *a,
+	       const short int *b)
+{
+  int i,d = 0;
+
+  for(i=1;i<=a[0];i++){
+    if (a[i] == b[i]){ continue; }
+    if (a[i] > i){ d++; }
+    if (b[i] > i){ d++; }
+  }
+  return d;
+}
+
+/*
+  generate all possible moves (less than n^2) into *array, which holds
+  *size moves and is enlarged as needed (NULL and 0 for a new one)
+*/
 static int
 construct_moves_new(const char *seq,
 		    const short *structure,
 		    int permute,
-		    move_str **array)
+		    move_str **array,
+		    int *size)
 {
-  /* generate all possible moves (less than n^2)*/
   int i;
-  int size = 4;
   int count = 0;
-  move_str *res = (move_str*) malloc(sizeof(move_str)*(size+1));
+  move_str *res = *array;
+
+  if (res == NULL || *size < 4) {
+    *size = 4;
+    res = (move_str*) realloc(res, sizeof(move_str)*(*size));
+    assert(res!=NULL);
+  }
   
   for (i=1; i<=structure[0]; i++) {
     if (structure[i]!=0) {
       if (structure[i]<i) continue;
       count ++;
       // need to reallocate the array?
-      if (count>size) {
-      	size *= 2;
-      	res = realloc(res, sizeof(move_str)*(size));
+      if (count>*size) {
+      	*size *= 2;
+      	res = realloc(res, sizeof(move_str)*(*size));
+      	assert(res!=NULL);
       }
       res[count-1].left = -i;
       res[count-1].right = -structure[i];
@@ -89,9 +166,10 @@ construct_moves_new(const char *seq,
           if (try_insert_seq2(seq,i,j)) {
             count ++;
 	    // need to reallocate the array?
-	    if (count>size) {
-	      size *= 2;
-	      res = realloc(res, sizeof(move_str)*(size));
+	    if (count>*size) {
+	      *size *= 2;
+	      res = realloc(res, sizeof(move_str)*(*size));
+	      assert(res!=NULL);
 	    }
 	    res[count-1].left = i;
 	    res[count-1].right = j;
@@ -105,8 +183,6 @@ construct_moves_new(const char *seq,
     }
   }
   
-  res = realloc(res, sizeof(move_str)*(count));
-  
   /* permute them */
   if (permute) {
     for (i=0; i<count; i++) {
@@ -122,6 +198,42 @@ construct_moves_new(const char *seq,
   return count;
 }
 
+/*
+  ln of the number of secondary structures of seq, i.e. of the states
+  the move set can reach (canonical pairs enclosing more than MINGAP
+  unpaired bases); O(n^3) count of the structures Q(i,j) on
+  seq[i..j] by the pairing partner of j, in long double s.t. it does
+  not overflow for sequences of several thousand nt
+ */
+double
+structure_count_log(const char *seq)
+{
+  int i,j,k;
+  const int n = strlen(seq);
+  double res;
+  long double *q=NULL,sum;
+#define Q(I,J) q[(size_t)(I)*(n+2)+(J)]
+
+  q = (long double*)calloc((size_t)(n+2)*(n+2), sizeof(long double));
+  assert(q!=NULL);
+  for(i=1;i<=n+1;i++){
+    for(j=i-1;j<=MIN2(i+MINGAP,n);j++){ Q(i,j) = 1.; }
+  }
+  for(i=n;i>=1;i--){
+    for(j=i+MINGAP+1;j<=n;j++){
+      sum = Q(i,j-1);  /* j unpaired */
+      for(k=i;k<j-MINGAP;k++){
+	if (compat(seq[k-1],seq[j-1])){ sum += Q(i,k-1)*Q(k+1,j-1); }
+      }
+      Q(i,j) = sum;
+    }
+  }
+  res = (double)logl(Q(1,n));
+#undef Q
+  free(q);
+  return res;
+}
+
 /*  try insert base pair (i,j) */
 inline int
 try_insert_seq2(const char *seq,
@@ -3,12 +3,40 @@
 #ifndef __MOVES__
 #define __MOVES__
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <gsl/gsl_rng.h>
+
 typedef struct move_str {
   int left;
   int right;
 } move_str;
 
-move_str get_random_move_pt(const char *,const short int*);
-void apply_move_pt(short int *,const move_str);
+/* 64-bit key of base pair (i,j) for Zobrist hashing of structures */
+static inline uint64_t
+pair_key(const int i, const int j)
+{
+  uint64_t x = ((uint64_t)i << 32) | (uint64_t)j;
+  x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/* change (+1/-1) of the base-pair distance to ref by move m */
+static inline int
+move_distance(const short int *ref, const move_str m)
+{
+  const int shared = (ref[abs(m.left)] == abs(m.right));
+
+  return ((m.left < 0) == shared) ? 1 : -1;
+}
+
+move_str get_random_move_pt(const char *,const short int*,int *,const gsl_rng *);
+int get_all_moves_pt(const char *,const short int*,move_str **);
+void apply_move_pt(short int *,const move_str,uint64_t *,const short int *,int *);
+uint64_t structure_hash_pt(const short int *);
+int bp_distance_pt(const short int *,const short int *);
+double structure_count_log(const char *);
 
 #endif
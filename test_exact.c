@@ -0,0 +1,184 @@
+/*
+  test_exact.c : exact DOS by dynamic programming against a complete
+                 enumeration of the structures by RNAsubopt (short
+                 sequences) and against the structure count (sequences
+                 too short for interior loops beyond MAXLOOP), and
+                 its output read back as a reference DOS
+  Last changed Time-stamp: <2026-10-19 23:41:30 mtw>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "wl_rna.h"
+#include "wl_exact.h"
+#include "wl_dosfile.h"
+#include "moves.h"
+#include <ViennaRNA/subopt.h>
+
+static int failed = 0;
+
+/* ==== */
+/* random sequence of length n */
+static char *
+random_sequence(const int n)
+{
+  int i;
+  char *seq = (char*)calloc(n+1, sizeof(char));
+
+  for(i=0;i<n;i++){
+    seq[i] = "ACGU"[rand()%4];
+  }
+  return seq;
+}
+
+/* ==== */
+/* # of structures per energy from the DP and from RNAsubopt with an
+   energy band that covers all structures */
+static void
+compare_subopt(const char *seq)
+{
+  int k,m,nsol=0,*e=NULL;
+  double total=0.;
+  vrna_md_t md;
+  vrna_fold_compound_t *vc=NULL;
+  vrna_subopt_solution_t *sol=NULL,*p=NULL;
+  dosvec *v = exact_dos(seq,37.);
+
+  vrna_md_set_default(&md);
+  md.temperature = 37.;
+  md.uniq_ML = 1;
+  vc = vrna_fold_compound(seq,&md,VRNA_OPTION_MFE);
+  sol = vrna_subopt(vc,1000000,0,NULL);
+  for(p=sol;p->structure!=NULL;p++){ nsol++; }
+  e = (int*)calloc(nsol+1, sizeof(int));
+  for(k=0,p=sol;p->structure!=NULL;p++,k++){
+    e[k] = (int)floor(p->energy*100.+0.5);
+  }
+  /* with the same counts at the energies of the DP, the same totals
+     mean that RNAsubopt found no others */
+  for(k=0;k<v->n;k++){
+    int cnt=0;
+    total += v->c[k];
+    for(m=0;m<nsol;m++){ cnt += (e[m] == v->e[k]); }
+    if (cnt != (int)v->c[k]){
+      fprintf(stderr,"FAIL %s: %g structures at %d, RNAsubopt %d\n",
+	      seq,v->c[k],v->e[k],cnt);
+      failed++;
+      break;
+    }
+  }
+  if ((int)total != nsol){
+    fprintf(stderr,"FAIL %s: %g structures, RNAsubopt %d\n",seq,total,nsol);
+    failed++;
+  }
+  for(p=sol;p->structure!=NULL;p++){ free(p->structure); }
+  free(sol);
+  free(e);
+  vrna_fold_compound_free(vc);
+  dosvec_free(v);
+}
+
+/* ==== */
+/* total # of structures from the DP and from the count */
+static void
+compare_count(const char *seq)
+{
+  int k;
+  double total=0.,ref;
+  dosvec *v = exact_dos(seq,37.);
+
+  for(k=0;k<v->n;k++){ total += v->c[k]; }
+  ref = structure_count_log(seq);
+  if (fabs(log(total)-ref) > 1e-9){
+    fprintf(stderr,"FAIL %s: ln(# structures) %.12g, count %.12g\n",
+	    seq,log(total),ref);
+    failed++;
+  }
+  dosvec_free(v);
+}
+
+/* ==== */
+/* counts of v written on the n bins with edges range[] and read back
+   with read_reference_dos(); the bin counts add up to the structures
+   in range */
+static void
+round_trip(const char *what,
+	   const dosvec *v,
+	   const double *range,
+	   const int n)
+{
+  int i,j,k;
+  double c,en;
+  const char *fn = "test_exact.ref";
+  FILE *fp = fopen(fn,"w");
+  dosfile *d=NULL;
+
+  dosvec_fprintf(fp,v,range,n);
+  fclose(fp);
+  d = read_reference_dos(fn);
+  for(i=0;i<d->n;i++){
+    for(j=0;j<n-1 && fabs((range[j]+range[j+1])/2 - d->e[i]) > 0.005;j++);
+    c = 0.;
+    for(k=0;k<v->n;k++){
+      en = (double)v->e[k]/100;
+      if (en >= range[j] && en < range[j+1]){ c += v->c[k]; }
+    }
+    if (fabs(d->lg[i] - log(c)) > 1e-12*(1.+log(c))){
+      fprintf(stderr,"FAIL %s: ln g %.15g at %6.2f, expected %.15g\n",
+	      what,d->lg[i],d->e[i],log(c));
+      failed++;
+    }
+  }
+  free_dos_file(d);
+  remove(fn);
+}
+
+/* ==== */
+int
+main(void)
+{
+  int t,n;
+  char *seq=NULL;
+
+  /* a single structure in the lowest bin (ln g = 0) and a count
+     that needs all digits */
+  {
+    int e[4] = {-523, -471, -466, 130};
+    double c[4] = {1., 2., 5., 1234567890123.}, range[21];
+    dosvec v = {4, e, c};
+
+    for(t=0;t<=20;t++){ range[t] = -5.3 + 0.5*t; }
+    round_trip("fixed counts",&v,range,20);
+  }
+
+  srand(4711);
+  for(t=0;t<20;t++){
+    n = 12+t%10;
+    seq = random_sequence(n);
+    compare_subopt(seq);
+    free(seq);
+  }
+  compare_subopt("GGGGAAAACCCCAUGCAUGCAUG");
+  {
+    double range[201];
+    dosvec *v = exact_dos("GGGGAAAACCCCAUGCAUGCAUG",37.);
+
+    for(t=0;t<=200;t++){ range[t] = -20. + 0.2*t; }
+    round_trip("GGGGAAAACCCCAUGCAUGCAUG",v,range,200);
+    dosvec_free(v);
+  }
+  /* no interior loop of more than MAXLOOP unpaired bases fits in 37 nt */
+  for(t=0;t<10;t++){
+    n = 28+t;
+    seq = random_sequence(n);
+    compare_count(seq);
+    free(seq);
+  }
+  if (failed){
+    fprintf(stderr,"%d check(s) failed\n",failed);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/*
+  test_thermo.c : thermodynamic quantities from DOS with one and two
+                  states against their closed forms
+  Last changed Time-stamp: <2026-10-19 23:05:12 mtw>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "wl_thermo.h"
+
+static int failed = 0;
+
+/* ==== */
+static void
+expect(const char *what,
+       const double got,
+       const double want)
+{
+  if (fabs(got-want) > 1e-9*(1.+fabs(want))){
+    fprintf(stderr,"FAIL %s: got %.12g, expected %.12g\n",what,got,want);
+    failed++;
+  }
+}
+
+/* ==== */
+int
+main(void)
+{
+  const double T[2] = {37., 0.};
+  int k;
+  thermo *th = thermo_init(T,2);
+
+  /* a single structure at E = -10 kcal/mol: lnZ = 10 beta, F = U = -10,
+     S = C = 0 */
+  {
+    const double range[2] = {-10.05, -9.95};
+    const double lg[1] = {0.};
+
+    thermo_compute(th,range,lg,1);
+    for(k=0;k<2;k++){
+      expect("one state lnZ",th->lnZ[k],10.*th->beta[k]);
+      expect("one state F",th->F[k],-10.);
+      expect("one state U",th->U[k],-10.);
+      expect("one state S",th->S[k],0.);
+      expect("one state C",th->C[k],0.);
+      expect("one state dos_log_sum",
+	     dos_log_sum(range,lg,1,th->beta[k]),th->lnZ[k]);
+    }
+  }
+
+  /* one structure at E = -10 and two at E = -9 kcal/mol, i.e.
+     Z = exp(10 beta) + 2 exp(9 beta) */
+  {
+    const double range[3] = {-10.5, -9.5, -8.5};
+    const double lg[2] = {0., log(2.)};
+
+    thermo_compute(th,range,lg,2);
+    for(k=0;k<2;k++){
+      const double b = th->beta[k], tk = T[k]+K0;
+      const double p0 = 1./(1.+2.*exp(-b)), p1 = 1.-p0;
+      const double lnZ = 10.*b + log(1.+2.*exp(-b));
+      const double F = -lnZ/b, U = -10.*p0 - 9.*p1;
+
+      expect("two states lnZ",th->lnZ[k],lnZ);
+      expect("two states F",th->F[k],F);
+      expect("two states U",th->U[k],U);
+      expect("two states S",th->S[k],1000.*(U-F)/tk);
+      expect("two states C",th->C[k],1000.*p0*p1*b/tk);
+      expect("two states dos_log_sum",dos_log_sum(range,lg,2,b),lnZ);
+    }
+    expect("two states count",dos_log_sum(range,lg,2,0.),log(3.));
+  }
+
+  /* the same two states from their enthalpies and entropies: H = -10,
+     S = 0 and H = -9, S = 0 with g = 2, and a state with H = -20,
+     S = -50 cal/(mol K), i.e. E = -20 + 50 T/1000 */
+  {
+    const double H[3] = {-10., -9., -20.};
+    const double S[3] = {0., 0., -50.};
+    const double lg[3] = {0., log(2.), 0.};
+
+    thermo_compute_hs(th,H,S,lg,3);
+    for(k=0;k<2;k++){
+      const double b = th->beta[k], tk = T[k]+K0;
+      const double e2 = -20. + 50.*tk/1000.;
+      const double w0 = exp(10.*b), w1 = 2.*exp(9.*b), w2 = exp(-b*e2);
+      const double z = w0+w1+w2;
+      const double U = (-10.*w0 - 9.*w1 - 20.*w2)/z;
+      const double U2 = (100.*w0 + 81.*w1 + 400.*w2)/z;
+
+      expect("hs lnZ",th->lnZ[k],log(z));
+      expect("hs F",th->F[k],-log(z)/b);
+      expect("hs U",th->U[k],U);
+      expect("hs S",th->S[k],1000.*(U+log(z)/b)/tk);
+      expect("hs C",th->C[k],1000.*(U2-U*U)*b/tk);
+    }
+  }
+
+  thermo_free(th);
+  if (failed){
+    fprintf(stderr,"%d check(s) failed\n",failed);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
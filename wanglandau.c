@@ -6,6 +6,14 @@
   Landau, PD and Tsai, S-H and Exler, M (2004) Am. J. Phys. 72:(10) 1294-1302
   A new approach to Monte Carlo simulations in statistical physics:
   Wang-Landau sampling
+
+  Liang, F and Liu, C and Carroll, RJ (2007) J. Am. Stat. Assoc.
+  102:(477) 305-320
+  Stochastic approximation in Monte Carlo computation
+
+  Schulz, BJ and Binder, K and Mueller, M and Landau, DP (2003)
+  Phys. Rev. E 67:(6) 067102
+  Avoiding boundary effects in Wang-Landau sampling
 */
 
 /*
@@ -26,6 +34,17 @@
 #include "wl_options.h"
 #include "wl_rna.h"
 #include "moves.h"
+#include "wl_dosfile.h"
+#include "wl_tmmc.h"
+#include "wl_nfold.h"
+#include "wl_looptree.h"
+#include "wl_hll.h"
+#include "wl_shared.h"
+#include "wl_thermo.h"
+#include "wl_exact.h"
+#include "wl_dos2d.h"
+#include "wl_observe.h"
+#include "wl_reservoir.h"
 #include <gsl/gsl_rng.h>
 #ifdef __MACH__
 #include <mach/mach_time.h>
@@ -48,16 +67,76 @@ int clock_gettime(int clk_id, struct timespec *t){
 
 #define MIN2(A, B)  ((A) < (B) ? (A) : (B))
 #define MAX2(A, B)  ((A) > (B) ? (A) : (B))
+#define LNU_BATCH 1024
+#define JOINT_DIST 1        /* g2 over (bin, base-pair distance) */
+#define JOINT_HS   2        /* g2 over (enthalpy, entropy) */
+#define HS_OFFSET  (1<<20)  /* keeps enthalpy/entropy cells >= 0 */
+
+/* state of one random walker; all walkers share g and h */
+typedef struct _walker {
+  short *pt;        /* pair table of the current structure */
+  int e;            /* its energy (dcal/mol) */
+  size_t b1;        /* its bin */
+  uint64_t zh;      /* its Zobrist hash */
+  int d;            /* its base-pair distance to pt_ref (--distance) */
+  int eh;           /* its enthalpy (dcal/mol) (--hs) */
+  looptree *lth;    /* its loop decomposition in enthalpies (--hs) */
+  int cx,cy;        /* its cell of g2 */
+  double obs[NOBS]; /* its observables (--production) ... */
+  uint64_t zobs;    /* ... as of the structure with this hash */
+  looptree *lt;     /* its loop decomposition */
+  gsl_rng *r;       /* random number stream of this walker */
+  int lnu_pos;      /* next unused entry of lnu */
+  double lnu[LNU_BATCH]; /* batch of ln(uniform random numbers) */
+} walker;
 
 /* functions */
 static void initialize_wl(void);
 static void initialize_dos_estimate(void);
+static void warmstart_dos_estimate(const char *);
+static void autoconfigure_range(const double);
+static double pilot_run(short *);
+static double greedy_ascent(short *);
 static void wl_montecarlo(char *);
 static gsl_histogram * scale_dos(gsl_histogram *);
+static double count_shift(const gsl_histogram *, const int);
 static void output_dos(const gsl_histogram *, const char);
 static short histogram_is_flat(const gsl_histogram *);
-static double partition_function(const gsl_histogram *);
-static gsl_histogram *ini_histogram_uniform(const int,const double,const double);
+static void output_thermo(const gsl_histogram *);
+static void output_exact_dos(void);
+static void output_dos2d(const double, const char);
+static double reference_error(const gsl_histogram *);
+static void check_convergence(const gsl_histogram *, const gsl_histogram *);
+static void check_invariants(const gsl_histogram *);
+static void set_histogram_layout(const int);
+static void refine_histograms(void);
+static void extend_layout(const double);
+static void grow_histograms(const double);
+static gsl_histogram *tmmc_dos(void);
+static void nfold_step(vrna_fold_compound_t *, walker *);
+static void step_production(vrna_fold_compound_t *, walker *);
+static void step_frozen(vrna_fold_compound_t *, walker *);
+static void step_trace(vrna_fold_compound_t *, walker *);
+static void step_shared(vrna_fold_compound_t *, walker *);
+static void step_shared_frozen(vrna_fold_compound_t *, walker *);
+static void step_joint(vrna_fold_compound_t *, walker *);
+static void step_hs(vrna_fold_compound_t *, walker *);
+static int hs_bin(const dos2d_cell *);
+static void thermo_hs(const double);
+static double scale_shift(const gsl_histogram *);
+static void production_run(vrna_fold_compound_t *, walker *, const int,
+			   void (*)(vrna_fold_compound_t *, walker *));
+static void output_observables(void);
+static void output_reservoir(void);
+static gsl_histogram *extend_histogram(gsl_histogram *,const double *,const size_t,const double);
+static void build_bin_lookup(void);
+static int enter_window(vrna_fold_compound_t *, short *, int, const gsl_rng *);
+static inline int energy_bin(const int);
+static inline double next_log_uniform(walker *);
+static inline int hs_x(const int);
+static inline int hs_y(const int, const int);
+static inline double hs_h(const int);
+static inline double hs_s(const int);
 
 /* variables */
 static int iterations = 0;    /* #iterations (modifications with f) */
@@ -66,11 +145,59 @@ static unsigned long steps = 0; /* # of WL steps */
 static unsigned long seed;    /* random seed */
 static gsl_rng *r = NULL;     /* GSL random number generator */
 static struct timespec ts;    /* timespec struct for random seed */
-static double rnum;           /* random number */
+static double pilot_emax = 0.;  /* highest energy seen in pilot run */
+static double greedy_emax = 0.; /* highest energy from greedy ascent */
+static double lnf;            /* log modification parameter f */
+static double lnf_stop;       /* value of lnf that ends the current stage */
+static long int crosscheck=1000000; /* used for convergence checks */
+static int steplimit_reached = 0;
+static int target_reached = 0; /* --target-error reached */
+static int converged = 0;     /* --tolerance reached on this level */
+static int stable = 0;        /* # of successive crosschecks within
+				 --tolerance */
+static char convergence[256]; /* criterion reached, for output */
+static int have_exact_G = 0;  /* whether exact_G is set */
+static int have_exact_lnN = 0; /* whether exact_lnN is set */
+static double exact_G = 0.;   /* ensemble free energy from vrna_pf() */
+static double exact_lnN = 0.; /* ln(# structures) from a DP count */
+static double dos_G = 0.;     /* ... and as implied by the DOS estimate */
+static double dos_lnN = 0.;
+static int level = 0;         /* current refinement level (0: finest) */
+static int layout_bins = 0;   /* # of bins in the finest layout */
+static int truedosbins_layout; /* truedosbins w.r.t. the finest layout */
+static double nfold_time = 0.; /* simulated # of steps in N-fold way mode */
+static int ebin_lo = 0;       /* lowest energy (dcal/mol) in ebin */
+static int ebin_hi = 0;       /* lowest energy (dcal/mol) above the
+				 sampling range */
+static int ewin_lo = 0;       /* lowest energy (dcal/mol) within the
+				 sampling range */
+static int window_exact = 1;  /* whether the sampling range starts at
+				 the mfe, s.t. subopt can normalize it */
 
 /* arrays */
 static gsl_histogram *g = NULL;  /* DoS histogram */
+static double *layout = NULL;    /* bin edges of the finest layout */
+static tmmc *tm = NULL;          /* transition-matrix proposal counts */
+static nfold *nf = NULL;         /* neighbor list for N-fold way mode */
+static loopcache *lc = NULL;     /* energies of loops seen before */
+static loopcache *sc = NULL;     /* energies of structures seen before */
+static hll *hl = NULL;           /* distinct structures per bin */
+static shared_dos *shd = NULL;   /* DOS shared with other processes */
+static thermo *th = NULL;        /* thermodynamics of the DOS estimate */
+static dos2d *g2 = NULL;         /* joint DOS over energy and distance,
+				    or enthalpy and entropy */
+static short *pt_ref = NULL;     /* reference structure of the distance */
+static vrna_fold_compound_t *vch = NULL; /* enthalpy parameters (--hs) */
+static loopcache *lch = NULL;    /* loop enthalpies seen before */
+static observables *ob = NULL;   /* per-bin observables (--production) */
+static short *pt_mfe = NULL;     /* mfe structure, for the observables */
+static reservoir *rs = NULL;     /* sampled structures per bin */
+static dosfile *ref = NULL;      /* reference DOS (--reference-dos) */
+static FILE *err_fp = NULL;      /* error trajectory w.r.t. ref */
+static gsl_histogram *gprev = NULL; /* scaled estimate at the previous
+				      crosscheck */
 static char *out_prefix=NULL;    /* prefix for output */
+static int *ebin = NULL;         /* bin of each energy in [ebin_lo,ebin_hi) */
 
 /* ==== */
 void
@@ -78,11 +205,40 @@ wanglandau(void)
 {
   initialize_wl();           /* set function pointers for current
 				model; allocate histograms */
-  pre_process_model();       /* get normalization factor for histogram
+  if (wanglandau_opt.exact){
+    output_exact_dos();      /* no sampling required */
+    post_process_model();
+    return;
+  }
+  if (window_exact){
+    pre_process_model();     /* get normalization factor for histogram
 				by populating the first bin */
+  }
   initialize_dos_estimate();  /* set initial DOS estimate to start
 				 with */
-  wl_montecarlo(wanglandau_opt.structure);
+  lnf = wanglandau_opt.finit;
+  if (wanglandau_opt.samc){
+    lnf = wanglandau_opt.gamma0;
+    fprintf(stderr,"# SAMC: gain drops below %g after %.4g steps\n",
+	    wanglandau_opt.ffinal,
+	    MAX2(wanglandau_opt.t0,
+		 wanglandau_opt.gamma0*wanglandau_opt.t0/wanglandau_opt.ffinal));
+  }
+  if (wanglandau_opt.shareddos != NULL){
+    shd = shared_dos_open(wanglandau_opt.shareddos,g,h,&lnf);
+  }
+  for(;;){
+    /* coarse levels only need to converge up to refinemod */
+    lnf_stop = wanglandau_opt.ffinal;
+    if (level > 0){
+      lnf_stop = MAX2(wanglandau_opt.refinemod,wanglandau_opt.ffinal);
+    }
+    wl_montecarlo(wanglandau_opt.structure);
+    if (level == 0 || steplimit_reached || target_reached){ break; }
+    refine_histograms();
+  }
+  shared_dos_close(shd,g,h);
+  shd = NULL;
   // scale_normalize_DOS();
   post_process_model();
   return;
@@ -92,9 +248,9 @@ wanglandau(void)
 static void
 initialize_wl(void)
 {
-  int bins,fnlen=512;
+  int fnlen=512;
   char *res_string=NULL;
-  double low,high,lo,hi,hmin,hmax,erange,*range = NULL;
+  double hmin,hmax,*range = NULL;
   
   srand(time(NULL));
   if(wanglandau_opt.verbose){
@@ -108,20 +264,82 @@ initialize_wl(void)
   /* set energy paramters for current model; compute mfe */
   initialize_model(wanglandau_opt.sequence); 
 
-  range = (double*)calloc((wanglandau_opt.bins+1), sizeof(double));
-  assert(range!=NULL);
+  /* prepare gsl random-number generation */
+  (void) clock_gettime(CLOCK_REALTIME, &ts);
+  if(wanglandau_opt.seed_given){
+    seed = wanglandau_opt.seed;
+  }
+  else {
+    seed =   ts.tv_sec ^ ts.tv_nsec;
+  }
+  fprintf(stderr, "initializing random seed: %lu\n",seed);
+  gsl_rng_env_setup();
+  r = gsl_rng_alloc (gsl_rng_mt19937);
+  gsl_rng_set( r, seed );
+  /* end gsl */
 
-  /* initialize histograms */
+  /* a window above the mfe has no exact low-energy counts; its ln g
+     is only known up to a constant, which RNAwl-merge determines */
   hmin=mfe;
-  if(wanglandau_opt.res_given){ /* determine histogram ranges manually */
+  if(wanglandau_opt.elow_given && wanglandau_opt.elow > mfe){
+    hmin = wanglandau_opt.elow;
+    window_exact = 0;
+    if(wanglandau_opt.truedosbins_given){
+      fprintf(stderr,"--truedosbins requires --elow <= mfe (%6.2f)\n",mfe);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if(wanglandau_opt.autorange){
+    autoconfigure_range(hmin);  /* sets max, res and bins */
+  }
+
+  /* global invariants of the (normalized) DOS, only computed if an
+     option needs them: the partition function costs a full vrna_pf()
+     and the count O(n^2) memory */
+  if(wanglandau_opt.pftol > 0. || wanglandau_opt.counttol > 0. ||
+     wanglandau_opt.normalize != NORM_BIN){
+    if(!window_exact){
+      fprintf(stderr,"--pf-tolerance/--count-tolerance/--normalize require --elow <= mfe\n");
+      exit(EXIT_FAILURE);
+    }
+    if(wanglandau_opt.pftol > 0.){
+      exact_G = ensemble_energy_RNA(wanglandau_opt.sequence);
+      have_exact_G = 1;
+      fprintf(stderr,"# exact ensemble free energy %8.3f kcal/mol\n",exact_G);
+    }
+    if(wanglandau_opt.counttol > 0. || wanglandau_opt.normalize != NORM_BIN){
+      exact_lnN = structure_count_log(wanglandau_opt.sequence);
+      have_exact_lnN = 1;
+      fprintf(stderr,"# exact ln(# structures) %g\n",exact_lnN);
+    }
+  }
+
+  /* initialize histograms */
+  if(wanglandau_opt.binedges != NULL){ /* user-defined bin edges */
+    range = read_bin_edges(wanglandau_opt.binedges,&wanglandau_opt.bins);
+    if(range[0] > mfe){
+      fprintf(stderr,"Lowest bin edge %6.2f is above the mfe %6.2f\n",
+	      range[0],mfe);
+      exit(EXIT_FAILURE);
+    }
+    hmin=range[0];
+    if(!wanglandau_opt.max_given){
+      wanglandau_opt.max=range[wanglandau_opt.bins];
+    }
+    hmax=wanglandau_opt.max;
+  }
+  else if(wanglandau_opt.res_given){ /* determine histogram ranges manually */
     int i;
-    range[0]=mfe;
+    range = (double*)calloc((wanglandau_opt.bins+1), sizeof(double));
+    assert(range!=NULL);
+    range[0]=hmin;
     for(i=1;i<=wanglandau_opt.bins;i++){
       range[i]=range[i-1]+wanglandau_opt.res;
     }
     if(wanglandau_opt.verbose){
       /* info output */
-      fprintf(stderr,"#allocating %lu bins of width %g\n",
+      fprintf(stderr,"#allocating %d bins of width %g\n",
 	      wanglandau_opt.bins,wanglandau_opt.res);
       /* fprintf(stderr,"#histogram ranges:\n #");
 	 for(i=0;i<=wanglandau_opt.bins;i++){
@@ -139,27 +357,130 @@ initialize_wl(void)
       wanglandau_opt.max=range[wanglandau_opt.bins]; /* the last element */
       hmax=wanglandau_opt.max;
     }
-    h = gsl_histogram_alloc(wanglandau_opt.bins);
-    g = gsl_histogram_alloc(wanglandau_opt.bins);
-    s = gsl_histogram_alloc(wanglandau_opt.bins);
-    gsl_histogram_set_ranges(h,range,(wanglandau_opt.bins+1));
-    gsl_histogram_set_ranges(g,range,(wanglandau_opt.bins+1));
-    gsl_histogram_set_ranges(s,range,(wanglandau_opt.bins+1));
   }
   else{  /* determine histogram ranges automatically */
+    int i;
     if(wanglandau_opt.max_given){
       hmax = wanglandau_opt.max;
     }
     else{
       hmax=20*fabs(mfe);
+      wanglandau_opt.max=hmax;
+    }
+    range = (double*)calloc((wanglandau_opt.bins+1), sizeof(double));
+    assert(range!=NULL);
+    for(i=0;i<=wanglandau_opt.bins;i++){
+      range[i]=hmin+((double)i/wanglandau_opt.bins)*(hmax-hmin);
     }
-    h = ini_histogram_uniform(wanglandau_opt.bins,hmin,hmax);
-    g = ini_histogram_uniform(wanglandau_opt.bins,hmin,hmax);
-    s = ini_histogram_uniform(wanglandau_opt.bins,hmin,hmax);
   }
   fprintf (stderr, "# sampling energy range is %6.2f - %6.2f\n",
 	   hmin,hmax);
+
+  /* thermodynamics on the --thermo grid, or at the simulation
+     temperature only */
+  if (wanglandau_opt.tgrid != NULL){
+    th = thermo_init(wanglandau_opt.tgrid,wanglandau_opt.ntemps);
+  }
+  else {
+    double t = wanglandau_opt.T;
+    th = thermo_init(&t,1);
+  }
+
+  /* joint DOS over (bin, base-pair distance); the marginal over the
+     distance takes the place of g */
+  if (wanglandau_opt.distance != DIST_NONE){
+    if (wanglandau_opt.distance == DIST_MFE){
+      char *s = mfe_structure_RNA(wanglandau_opt.sequence);
+      pt_ref = vrna_ptable(s);
+      free(s);
+    }
+    else {
+      pt_ref = vrna_ptable(wanglandau_opt.structure);
+    }
+    g2 = dos2d_init(16);
+  }
+  if (wanglandau_opt.hs){
+    g2 = dos2d_init(16);
+  }
+
+  /* keep the finest layout; start with the coarsest one if
+     hierarchical refinement is requested */
+  layout = range;
+  layout_bins = wanglandau_opt.bins;
+  truedosbins_layout = wanglandau_opt.truedosbins;
+  level = wanglandau_opt.refine;
+  set_histogram_layout(level);
+  
+  /* make prefix for output */
+  out_prefix = (char*)calloc(fnlen, sizeof(char));
+  res_string = (char*)calloc(16, sizeof(char));
+  sprintf(res_string,"%3.1f", wanglandau_opt.res);
+  strcpy(out_prefix, wanglandau_opt.basename); strcat(out_prefix, ".res");
+  strcat(out_prefix, res_string); strcat(out_prefix, ".");
+  free(res_string);
+
+  /* reference DOS and trajectory of the error of the estimate */
+  if (wanglandau_opt.refdos != NULL){
+    char *fn = (char*)calloc(strlen(out_prefix)+8, sizeof(char));
+    assert(fn!=NULL);
+    ref = read_reference_dos(wanglandau_opt.refdos);
+    sprintf(fn,"%serr",out_prefix);
+    if ((err_fp = fopen(fn, "w")) == NULL){
+      fprintf(stderr, "Cannot open %s for writing\n", fn);
+      exit(EXIT_FAILURE);
+    }
+    fprintf(err_fp, "# relative error of ln g w.r.t. %s\n",wanglandau_opt.refdos);
+    fprintf(err_fp, "# %18s %12s %12s %6s\n","steps","mean","max","bins");
+    free(fn);
+  }
+  return;
+}
+
+/* ==== */
+/* (re)allocate g, h and s with every (2^lev)-th edge of the finest
+   layout and determine the energy range of the true DOS bins */
+static void
+set_histogram_layout(const int lev)
+{
+  int i,n;
+  const int stride = 1<<lev;
+  double low,high,lo,hi,*range=NULL;
+
+  n = (layout_bins+stride-1)/stride;
+  range = (double*)calloc(n+1, sizeof(double));
+  assert(range!=NULL);
+  for(i=0;i<n;i++){
+    range[i] = layout[i*stride];
+  }
+  range[n] = layout[layout_bins];
+
+  if (g != NULL){
+    gsl_histogram_free(g);
+    gsl_histogram_free(h);
+    gsl_histogram_free(s);
+  }
+  h = gsl_histogram_alloc(n);
+  g = gsl_histogram_alloc(n);
+  s = gsl_histogram_alloc(n);
+  gsl_histogram_set_ranges(h,range,n+1);
+  gsl_histogram_set_ranges(g,range,n+1);
+  gsl_histogram_set_ranges(s,range,n+1);
   free(range);
+  wanglandau_opt.bins = n;
+  if (wanglandau_opt.tmmc){ /* counts refer to bins, so start over */
+    tmmc_free(tm);
+    tm = tmmc_init(n);
+  }
+  if (wanglandau_opt.hll > 0){
+    hll_free(hl);
+    hl = hll_init(n,wanglandau_opt.hll);
+  }
+  build_bin_lookup();
+  /* the true DOS covers (about) the same energy range on all levels */
+  wanglandau_opt.truedosbins = MIN2(MAX2((truedosbins_layout+stride-1)/stride,1),n);
+  if(lev > 0){
+    fprintf(stderr,"# refinement level %d: %d bins\n",lev,n);
+  }
   
   /* get the energy range up to which we will compute true DOS via
      RNAsubopt */
@@ -172,29 +493,207 @@ initialize_wl(void)
     printf("Using true DOS for bins 0-%d: (%6.3g -- %6.3g) wl_opt.erange=%6.3f\n",
 	   (wanglandau_opt.truedosbins-1),low,high,wanglandau_opt.erange);
   }
-  
-  /* prepare gsl random-number generation */
-  (void) clock_gettime(CLOCK_REALTIME, &ts);
-  if(wanglandau_opt.seed_given){
-    seed = wanglandau_opt.seed;
+}
+
+/* ==== */
+/* split the bins of the current level and interpolate ln g onto the
+   next finer level; ln(g/width) is interpolated linearly between the
+   midpoints of visited coarse bins */
+static void
+refine_histograms(void)
+{
+  int i,c,c2,top;
+  double x,xc,xc2,d,d2,lo,hi,w;
+  gsl_histogram *gc = gsl_histogram_clone(g);
+
+  top = maxbin;
+  set_histogram_layout(--level);
+  if (window_exact){
+    pre_process_model();  /* true DOS for the new layout */
   }
-  else {
-    seed =   ts.tv_sec ^ ts.tv_nsec;
+
+  maxbin = -1;
+  /* nothing to interpolate if no bin has been visited */
+  for(i=0;top>=0 && i<g->n;i++){
+    gsl_histogram_get_range(g,i,&lo,&hi);
+    x = lo+(hi-lo)/2;
+    w = hi-lo;
+    if (x >= gc->range[top+1]){ break; }
+    for(c=0; c<top && x >= gc->range[c+1]; c++);
+    if (gc->bin[c] == 0.){ continue; } /* not visited so far */
+    xc = gc->range[c]+(gc->range[c+1]-gc->range[c])/2;
+    d  = gc->bin[c]-log(gc->range[c+1]-gc->range[c]);
+    c2 = (x < xc) ? c-1 : c+1;
+    if (c2 >= 0 && c2 <= top && gc->bin[c2] != 0.){
+      xc2 = gc->range[c2]+(gc->range[c2+1]-gc->range[c2])/2;
+      d2  = gc->bin[c2]-log(gc->range[c2+1]-gc->range[c2]);
+      d  += (d2-d)*(x-xc)/(xc2-xc);
+    }
+    g->bin[i] = d+log(w);
+    maxbin = i;
   }
-  fprintf(stderr, "initializing random seed: %d\n",seed);
-  gsl_rng_env_setup();
-  r = gsl_rng_alloc (gsl_rng_mt19937);
-  gsl_rng_set( r, seed );
-  /* end gsl */
+  gsl_histogram_free(gc);
 
-  /* make prefix for output */
-  out_prefix = (char*)calloc(fnlen, sizeof(char));
-  res_string = (char*)calloc(16, sizeof(char));
-  sprintf(res_string,"%3.1f", wanglandau_opt.res);
-  strcpy(out_prefix, wanglandau_opt.basename); strcat(out_prefix, ".res");
-  strcat(out_prefix, res_string); strcat(out_prefix, ".");
-  free(res_string);
-  return;
+  if (wanglandau_opt.truedosbins_given){
+    for (i=0;i<wanglandau_opt.truedosbins;i++){
+      g->bin[i]=log(s->bin[i]);
+    }
+  }
+  fprintf(stderr,"# steps=%20li | f=%12g | refined histogram to %d bins\n",
+	  steps,lnf,wanglandau_opt.bins);
+}
+
+/* ==== */
+/* append bins to the finest layout s.t. it reaches up to top */
+static void
+extend_layout(const double top)
+{
+  int i,k;
+  const double w = layout[layout_bins]-layout[layout_bins-1];
+
+  if (top <= layout[layout_bins]){ return; }
+  k = (int)ceil((top-layout[layout_bins])/w - 1e-9);
+  layout = (double*)realloc(layout,(layout_bins+k+1)*sizeof(double));
+  assert(layout!=NULL);
+  for(i=1;i<=k;i++){
+    layout[layout_bins+i] = layout[layout_bins]+i*w;
+  }
+  layout_bins += k;
+}
+
+/* ==== */
+/* choose sampling range and bin layout from the lowest energy lo
+   (mfe or --elow), a short exploratory walk and a greedy ascent to a
+   (local) energy maximum */
+static void
+autoconfigure_range(const double lo)
+{
+  int bins;
+  short *pt=NULL;
+  double top,margin;
+
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"[[autoconfigure_range()]]\n");
+  }
+  pt = vrna_ptable(wanglandau_opt.structure);
+  pilot_emax  = pilot_run(pt);   /* leaves the highest structure in pt */
+  greedy_emax = greedy_ascent(pt);
+  free(pt);
+
+  top = MAX2(pilot_emax,greedy_emax);
+  /* leave headroom for excursions the pilot run has not seen */
+  margin = MAX2(0.1*(top-lo), 2*wanglandau_opt.res);
+  if(!wanglandau_opt.max_given){
+    wanglandau_opt.max = top+margin;
+  }
+  bins = (int)ceil((wanglandau_opt.max-lo)/wanglandau_opt.res);
+  wanglandau_opt.bins = MAX2(bins,wanglandau_opt.truedosbins);
+  if(!wanglandau_opt.ehigh_given){
+    wanglandau_opt.max = lo + wanglandau_opt.bins*wanglandau_opt.res;
+  }
+  wanglandau_opt.res_given = 1;
+  wanglandau_opt.max_given = 1;
+
+  fprintf(stderr,
+	  "# auto: pilot max %6.2f, greedy max %6.2f -> %d bins of width %g up to %6.2f\n",
+	  pilot_emax,greedy_emax,wanglandau_opt.bins,wanglandau_opt.res,
+	  wanglandau_opt.max);
+}
+
+/* ==== */
+/* exploratory WL walk with constant f over a wide, coarse energy
+   grid; returns the highest energy seen and leaves the corresponding
+   structure in pt */
+static double
+pilot_run(short *pt)
+{
+  int e,enew,nb;
+  long int i;
+  size_t b1,b2;
+  short *cur=NULL;
+  move_str m;
+  double *lg=NULL,emax;
+  const double width = 1.;  /* kcal/mol */
+  const double top = mfe + MAX2(100.,40*fabs(mfe));
+  vrna_md_t md;
+  vrna_fold_compound_t *vc=NULL;
+
+  vrna_md_set_default(&md);
+  md.temperature = wanglandau_opt.T;
+  vc = vrna_fold_compound(wanglandau_opt.sequence,&md,VRNA_OPTION_EVAL_ONLY);
+
+  nb = (int)ceil((top-mfe)/width);
+  lg = (double*)calloc(nb,sizeof(double));
+  cur = (short*)calloc(pt[0]+1,sizeof(short));
+  assert(lg!=NULL); assert(cur!=NULL);
+  memcpy(cur,pt,(pt[0]+1)*sizeof(short));
+
+  e = vrna_eval_structure_pt(vc,cur);
+  emax = (double)e/100;
+  b1 = (size_t)MIN2(MAX2(((double)e/100-mfe)/width,0),nb-1);
+  for(i=0;i<wanglandau_opt.pilotsteps;i++){
+    m = get_random_move_pt(wanglandau_opt.sequence,cur,NULL,r);
+    enew = e + vrna_eval_move_pt(vc,cur,m.left,m.right);
+    if ((double)enew/100 < top){  /* out-of-grid proposals are rejected */
+      b2 = (size_t)MAX2(((double)enew/100-mfe)/width,0);
+      if (lg[b2] <= lg[b1] || gsl_rng_uniform(r) < exp(lg[b1]-lg[b2])){
+	apply_move_pt(cur,m,NULL,NULL,NULL);
+	e = enew;
+	b1 = b2;
+	if ((double)e/100 > emax){
+	  emax = (double)e/100;
+	  memcpy(pt,cur,(pt[0]+1)*sizeof(short));
+	}
+      }
+    }
+    lg[b1] += 1.;
+  }
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"pilot run: %li steps, highest energy %6.2f\n",
+	    wanglandau_opt.pilotsteps,emax);
+  }
+  free(cur);
+  free(lg);
+  vrna_fold_compound_free(vc);
+  return emax;
+}
+
+/* ==== */
+/* steepest ascent from pt to a local energy maximum; returns its
+   energy */
+static double
+greedy_ascent(short *pt)
+{
+  int i,e,de,best,count;
+  move_str *mvs=NULL,bm;
+  vrna_md_t md;
+  vrna_fold_compound_t *vc=NULL;
+
+  vrna_md_set_default(&md);
+  md.temperature = wanglandau_opt.T;
+  vc = vrna_fold_compound(wanglandau_opt.sequence,&md,VRNA_OPTION_EVAL_ONLY);
+
+  e = vrna_eval_structure_pt(vc,pt);
+  for(;;){
+    best = 0;
+    count = get_all_moves_pt(wanglandau_opt.sequence,pt,&mvs);
+    for(i=0;i<count;i++){
+      de = vrna_eval_move_pt(vc,pt,mvs[i].left,mvs[i].right);
+      if (de > best){
+	best = de;
+	bm = mvs[i];
+      }
+    }
+    free(mvs);
+    if (best == 0){ break; }
+    apply_move_pt(pt,bm,NULL,NULL,NULL);
+    e += best;
+  }
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"greedy ascent: local maximum at %6.2f\n",(double)e/100);
+  }
+  vrna_fold_compound_free(vc);
+  return (double)e/100;
 }
 
 /* ==== */
@@ -208,7 +707,28 @@ initialize_dos_estimate(void)
     fprintf(stderr, "[[initialize_dos_estimate()]]\n");
   }
   
-  if (wanglandau_opt.truedosbins_given){
+  if (wanglandau_opt.initdos != NULL){
+    /* start from a previous estimate, interpolated onto the current
+       binning */
+    if(wanglandau_opt.verbose){
+      fprintf(stderr, "initializing DOS estimate g from %s\n",
+	      wanglandau_opt.initdos);
+    }
+    warmstart_dos_estimate(wanglandau_opt.initdos);
+    if (wanglandau_opt.truedosbins_given){
+      /* shift the estimate s.t. it joins the true DOS values from
+	 RNAsubopt, then overwrite the lowest bins with them */
+      double shift = log(s->bin[wanglandau_opt.truedosbins-1])
+	- g->bin[wanglandau_opt.truedosbins-1];
+      for(i=0;i<n;i++){
+	g->bin[i] += shift;
+      }
+      for (i=0;i<wanglandau_opt.truedosbins;i++){
+	g->bin[i]=log(s->bin[i]);
+      }
+    }
+  }
+  else if (wanglandau_opt.truedosbins_given){
     /* initialize the first n bins of g with true DOS as computed by
        RNAsubopt */
     if(wanglandau_opt.verbose){
@@ -235,83 +755,100 @@ initialize_dos_estimate(void)
 
 
 
+/* ==== */
+/* interpolate a DOS from a previous run onto the bins of g */
+static void
+warmstart_dos_estimate(const char *fn)
+{
+  size_t i;
+  double lo,hi;
+  dosfile *d = read_dos_file(fn);
+
+  for(i=0;i<g->n;i++){
+    gsl_histogram_get_range(g,i,&lo,&hi);
+    g->bin[i] = interpolate_dos(d,lo+(hi-lo)/2);
+    /* ln g is per bin, so correct for a different bin width of the
+       originating run */
+    if (d->width > 0.){
+      g->bin[i] += log((hi-lo)/d->width);
+    }
+  }
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"read %d entries (bin width %g) from %s\n",
+	    d->n,d->width,fn);
+  }
+  free_dos_file(d);
+}
+
 /* ==== */
 static void
 wl_montecarlo(char *struc)
 {
-  short *pt=NULL;
-  move_str m;
-  int e,enew,emove,eval_me,status,debug=1;
-  long int crosscheck=1000000; /* used for convergence checks */
+  int k,n,eval_me,status,debug=1;
+  unsigned long steps0 = steps;    /* steps performed in earlier stages */
+  struct timespec tstart,tnow;     /* for measuring throughput */
   long int crosscheck_limit = 100000000000000000;
-  double g_b1,g_b2,prob,lnf = 1.;  /* log modification parameter f */
-  size_t b1,b2;                    /* indices in g/h corresponding to
-				      old/new energies */
+  void (*step)(vrna_fold_compound_t *, walker *);
+  walker *wk=NULL,*w=NULL;         /* walkers, current walker */
+  size_t i;
   gsl_histogram *gcp=NULL; /* clone of g used during crosscheck output */ 
+  gsl_histogram *gtm=NULL; /* TMMC estimate at a crosscheck */
 
-  eval_me = 1; /* paranoid checking of neighbors against RNAeval */
+  eval_me = wanglandau_opt.verify; /* paranoid checking of energies
+				      against RNAeval */
   if (wanglandau_opt.verbose){
     printf("[[wl_montecarlo()]]\n");
   }
-  pt = vrna_ptable(struc);
-  //mtw_dump_pt(pt);
-  //char *str = vrna_pt_to_db(pt);
-  //printf(">%s<\n",str);
   vrna_md_t md;
   vrna_md_set_default(&md);
   md.temperature = wanglandau_opt.T;
   vrna_fold_compound_t *vc = vrna_fold_compound(wanglandau_opt.sequence,&md,VRNA_OPTION_EVAL_ONLY);
-  e = vrna_eval_structure_pt(vc,pt);
-  
-  /* determine bin where the start structure goes */
-  status = gsl_histogram_find(g,(float)e/100,&b1);
-  if (status) {
-    if (status == GSL_EDOM){
-      printf ("error: %s\n", gsl_strerror (status));
-    }
-    else {fprintf(stderr, "GSL error: gsl_errno=%d\n",status);}
-    exit(EXIT_FAILURE);
+  if (wanglandau_opt.statecache > 0 && sc == NULL){
+    sc = loopcache_init(wanglandau_opt.statecache);
   }
-  printf("%s\n", wanglandau_opt.sequence);
-  print_str(stderr,pt);
-  printf(" (%6.2f) bin:%d\n",(float)e/100,b1);
-  if (wanglandau_opt.verbose){
-    fprintf(stderr,"\nStarting MC loop ...\n");
+  if (wanglandau_opt.loopcache > 0 && lc == NULL){
+    lc = loopcache_init(wanglandau_opt.loopcache);
   }
-  while (lnf > wanglandau_opt.ffinal) {
-    if(wanglandau_opt.debug){
-      fprintf(stderr,"\n==================\n");
-      fprintf(stderr,"in while: lnf=%8.6f\n",lnf);
-      fprintf(stderr,"steps: %d\n",steps);
-      fprintf(stderr,"current histogram g:\n");
-      gsl_histogram_fprintf(stderr,g,"%6.2f","%30.6f");
-      fprintf(stderr,"\n");
-      print_str(stderr,pt);
-      fprintf(stderr, " (%6.2f) bin:%d\n",(float)e/100,b1);
-      /*  mtw_dump_pt(pt); */
-    }
-    /* make a random move */
-    m = get_random_move_pt(wanglandau_opt.sequence,pt);
-    /* compute energy difference for this move */
-    emove = vrna_eval_move_pt(vc,pt,m.left,m.right);
-    /* evaluate energy of the new structure */
-    enew = e + emove;
-    if(wanglandau_opt.debug){
-      fprintf(stderr,
-	      "random move: left %i right %i enew(%6.4f)=e(%6.4f)+emove(%6.4f)\n",
-	      m.left,m.right,(float)enew/100,(float)e/100,(float)emove/100);
+  if (wanglandau_opt.hs){
+    /* at 0 K, the energy parameters are the enthalpies */
+    vrna_md_t mdh = md;
+    mdh.temperature = -K0;
+    vch = vrna_fold_compound(wanglandau_opt.sequence,&mdh,VRNA_OPTION_EVAL_ONLY);
+    if (wanglandau_opt.loopcache > 0 && lch == NULL){
+      lch = loopcache_init(wanglandau_opt.loopcache);
     }
+  }
 
-    /* ensure the new energy is within sampling range */
-    if ((float)enew/100 >= wanglandau_opt.max){
-      fprintf(stderr,
-	      "New structure has energy %6.2f >= %6.2f (upper energy bound)\n",
-	      (float)enew/100,wanglandau_opt.max);
-      fprintf(stderr,"Please increase --bins or adjust --max! Exiting ...\n");
-      exit(EXIT_FAILURE);
+  /* all walkers start from the same structure; walker 0 uses the
+     global random number stream */
+  n = wanglandau_opt.walkers;
+  wk = (walker*)calloc(n, sizeof(walker));
+  assert(wk!=NULL);
+  for(k=0;k<n;k++){
+    w = &wk[k];
+    if (k == 0){
+      w->r = r;
     }
-    /* determine bin where the new structure goes */
-    status = gsl_histogram_find(g,(float)enew/100,&b2);
+    else {
+      w->r = gsl_rng_alloc(gsl_rng_mt19937);
+      gsl_rng_set(w->r, seed+k);
+    }
+    w->pt = vrna_ptable(struc);
+    w->e = vrna_eval_structure_pt(vc,w->pt);
+    if (w->e < ewin_lo || w->e >= ebin_hi){
+      w->e = enter_window(vc,w->pt,w->e,w->r);
+    }
+    w->zh = structure_hash_pt(w->pt);
+    w->lnu_pos = LNU_BATCH;
+    if (wanglandau_opt.nfold){
+      nf = nfold_init(vc,wanglandau_opt.sequence,w->pt);
+    }
+    else {
+      w->lt = looptree_init(vc,w->pt,lc);
+    }
+  
+    /* determine bin where the start structure goes */
+    status = gsl_histogram_find(g,(float)w->e/100,&w->b1);
     if (status) {
       if (status == GSL_EDOM){
 	printf ("error: %s\n", gsl_strerror (status));
@@ -319,67 +856,90 @@ wl_montecarlo(char *struc)
       else {fprintf(stderr, "GSL error: gsl_errno=%d\n",status);}
       exit(EXIT_FAILURE);
     }
-
-    steps++;  /* # of MC steps performed so far */
-
-    /* lookup current values for bins b1 and b2 */
-    g_b1 = gsl_histogram_get(g,b1);
-    g_b2 = gsl_histogram_get(g,b2);
-      
-    /* core MC steps */
-    prob = MIN2(exp(g_b1 - g_b2), 1.0);
-    rnum =  gsl_rng_uniform (r);
-    
-    if ((prob == 1 || (rnum <= prob)) ) { /* accept & apply the move */
-      apply_move_pt(pt,m);
-      if(wanglandau_opt.debug){
-	print_str(stderr,pt);
-	fprintf(stderr, " %6.2f bin:%d [A]\n", (float)enew/100,b2);
-      }
-      b1 = b2;
-      e = enew;
+    if (vch != NULL){
+      w->lth = looptree_init(vch,w->pt,lch);
+      w->eh = looptree_energy(w->lth);
+      w->cx = hs_x(w->eh);
+      w->cy = hs_y(w->eh,w->e);
     }
-    else { /* reject the move */
-      if(wanglandau_opt.debug){
-	print_str(stderr,pt);
-	fprintf(stderr, " (%6.2f) bin:%d [R]\n", (float)enew/100,b2);
-       }
+    else if (g2 != NULL){
+      w->d = bp_distance_pt(pt_ref,w->pt);
+      w->cx = w->b1;
+      w->cy = w->d;
     }
-    
-    /* update histograms g and h */
-    if(wanglandau_opt.truedosbins_given && b2 <= wanglandau_opt.truedosbins){
-      /* do not update if b2 <= truedosbins, i.e. keep true DOS values
-	 in those bins */
-      if (wanglandau_opt.debug){
-	fprintf(stderr, "NOT UPDATING bin %d\n",b1);
-      }
-    } else{
-      if(wanglandau_opt.debug){
-	fprintf(stderr, "UPDATING bin %d\n",b1); 
-      }
-      status = gsl_histogram_increment(h,(float)e/100);
-      status = gsl_histogram_accumulate(g,(float)e/100,lnf);
+    if (g2 != NULL){
+      (void) dos2d_insert(g2,w->cx,w->cy,0.);
+    }
+  }
+  /* structures are sampled on the finest level only */
+  if (level == 0 && wanglandau_opt.reservoir > 0 && rs == NULL){
+    rs = reservoir_init(g->n,wanglandau_opt.reservoir,wanglandau_opt.len);
+  }
+  /* convergence is judged per refinement level */
+  if (gprev != NULL){
+    gsl_histogram_free(gprev);
+    gprev = NULL;
+  }
+  stable = converged = 0;
+  if (steps == 0){
+    printf("%s\n", wanglandau_opt.sequence);
+  }
+  print_str(stderr,wk[0].pt);
+  printf(" (%6.2f) bin:%zu\n",(float)wk[0].e/100,wk[0].b1);
+  if (wanglandau_opt.verbose){
+    fprintf(stderr,"\nStarting MC loop ...\n");
+  }
+  /* select the step variant once */
+  if (wanglandau_opt.debug || eval_me){
+    step = step_trace;
+  }
+  else if (nf != NULL){
+    step = nfold_step;
+  }
+  else if (shd != NULL){
+    step = wanglandau_opt.truedosbins_given ? step_shared_frozen : step_shared;
+  }
+  else if (wanglandau_opt.truedosbins_given){
+    step = step_frozen;
+  }
+  else if (g2 != NULL){
+    step = (vch != NULL) ? step_hs : step_joint;
+  }
+  else {
+    step = step_production;
+  }
+  (void) clock_gettime(CLOCK_MONOTONIC, &tstart);
+  k = 0;
+  while (lnf > lnf_stop) {
+    /* walkers take turns; the data of the next one is fetched while
+       the current one is stepping */
+    w = &wk[k];
+    k = (k+1 == n) ? 0 : k+1;
+    if (n > 1){
+      __builtin_prefetch(wk[k].pt);
+      __builtin_prefetch(&g->bin[wk[k].b1],1);
+      __builtin_prefetch(&h->bin[wk[k].b1],1);
     }
-    maxbin = MAX2(maxbin,(int)b1);
-   
-    // stuff that can be skipped 
-    /*
-      printf ("performed move l:%4d r:%4d\t Energy +/- %6.2f\n",m.left,m.right,(float)emove/100);
-      print_str(stderr,pt);printf(" %6.2f bin:%d\n",(float)enew/100,b2);
-      e = vrna_eval_structure_pt(wanglandau_opt.sequence,pt,P);
-      if (eval_me == 1 && e != enew){
-      fprintf(stderr, "energy evaluation against vrna_eval_structure_pt() mismatch... HAVE %6.2f != %6.2f (SHOULD BE)\n",(float)enew/100, (float)e/100);
-      exit(EXIT_FAILURE);
-      }
-      print_str(stderr,pt);printf(" %6.2f\n",(float)e/100);
-    */
-    // end of stuff that can be skipped
 
+    steps++;  /* # of MC steps performed so far */
+    if (wanglandau_opt.samc){
+      /* SAMC: deterministic gain sequence instead of flatness-driven
+	 reduction of f */
+      lnf = wanglandau_opt.gamma0 * wanglandau_opt.t0
+	/ MAX2(wanglandau_opt.t0,(double)steps);
+    }
+    step(vc,w);
+    maxbin = MAX2(maxbin,(int)w->b1);
+    if (hl != NULL){ hll_add(hl,w->b1,w->zh); }
+    if (rs != NULL){ reservoir_add(rs,w->b1,w->pt,w->e,w->r); }
+   
     /* output DoS every x*10^(1/4) steps, starting with x=10^6 (we
        used this fopr comparing perfomance and convergence of
        different DoS sampling methods */
-    if((steps % crosscheck == 0) && (crosscheck <= crosscheck_limit)){
+    if((steps % crosscheck == 0) && (crosscheck <= crosscheck_limit) &&
+       (shd == NULL || shared_dos_writer(shd))){
       fprintf(stderr,"# crosscheck reached %li steps ",crosscheck);
+      if (g2 != NULL){ dos2d_project(g2,g->bin,g->n,(vch != NULL) ? hs_bin : NULL); }
       gcp = gsl_histogram_clone(g);
       if(wanglandau_opt.verbose){
 	fprintf(stderr,"## gcp before scaling\n");
@@ -390,51 +950,764 @@ wl_montecarlo(char *struc)
 	fprintf(stderr,"## gcp after scaling\n");
 	gsl_histogram_fprintf(stderr,gcp,"%6.2f","%30.6f");
       }
-      double Z = partition_function(gcp);
+      if (tm != NULL){
+	gtm = tmmc_dos();
+	scale_dos(gtm);
+      }
+      if (wanglandau_opt.tolerance > 0.){
+	check_convergence(gcp,gtm);
+      }
+      if (have_exact_G || have_exact_lnN){
+	check_invariants(gcp);
+      }
+      if (vch != NULL){ /* from the cells, not the marginal */
+	thermo_hs(scale_shift(gcp));
+      }
+      else {
+	thermo_compute(th,gcp->range,gcp->bin,maxbin+1);
+      }
       output_dos(gcp,'s');
-      fprintf(stderr, "Z=%10.4g\n", Z);
+      if (g2 != NULL){
+	output_dos2d(scale_shift(gcp),'s');
+      }
+      if (wanglandau_opt.thermo != NULL){
+	output_thermo(gcp);
+      }
+      if (ref != NULL){
+	double err = reference_error(gcp);
+	if (wanglandau_opt.target_error > 0. &&
+	    err <= wanglandau_opt.target_error){
+	  target_reached = 1;
+	}
+      }
+      if (gtm != NULL){
+	output_dos(gtm,'t');
+	gsl_histogram_free(gtm);
+	gtm = NULL;
+      }
+      if (hl != NULL){ /* ln of distinct structures seen per bin */
+	gsl_histogram *ghl = gsl_histogram_clone(g);
+	for(i=0;i<ghl->n;i++){
+	  double d = hll_estimate(hl,i);
+	  ghl->bin[i] = (d > 0.) ? log(d) : 0.;
+	}
+	output_dos(ghl,'c');
+	gsl_histogram_free(ghl);
+      }
+      fprintf(stderr, "lnZ=%10.4g (F=%8.3f at %g C)\n",
+	      th->lnZ[0],th->F[0],th->T[0]);
       crosscheck *= (pow(10, 1.0/4.0));
       gsl_histogram_free(gcp);
       fprintf(stderr,"->  new crosscheck will be performed at %li steps\n", crosscheck);
+      if (target_reached){
+	fprintf(stderr,"target error %g reached after %li steps, exiting ...\n",
+		wanglandau_opt.target_error,steps);
+	output_dos(g,'l');
+	if (g2 != NULL){ output_dos2d(0.,'l'); }
+	break;
+      }
+      if (converged){
+	fprintf(stderr,"# %s\n",convergence);
+	output_dos(g,'l');
+	if (g2 != NULL){ output_dos2d(0.,'l'); }
+	break;
+      }
     }
     
     if(steps % wanglandau_opt.checksteps == 0) {
-      if( histogram_is_flat(h) ) {
-	lnf /= 2;
+      int lead = 1;
+      if (shd != NULL){
+	/* one process at a time checks the shared histogram; f is
+	   picked up once the lead is decided, s.t. a reduction made in
+	   between is not missed */
+	lead = shared_dos_lead(shd);
+	lnf = shared_dos_lnf(shd);
+      }
+      if (nf != NULL){ /* events vs. simulated MC steps */
+	fprintf(stderr,"# N-fold way: %.6g MC steps\n",nfold_time);
+      }
+      if (g2 != NULL){
+	dos2d_project(g2,g->bin,g->n,(vch != NULL) ? hs_bin : NULL);
+      }
+      if (wanglandau_opt.samc){ /* no flatness checks in SAMC */
+	fprintf(stderr,"# steps=%20li | f=%12g | SAMC\n",steps,lnf);
+      }
+      else if (!lead){
+	fprintf(stderr,"# steps=%20li | f=%12g | checked by another worker\n",
+		steps,lnf);
+      }
+      else if( (g2 != NULL) ? dos2d_is_flat(g2,wanglandau_opt.flat)
+	       : histogram_is_flat(h) ) {
+	if (wanglandau_opt.tmmcbias){
+	  /* WL-TM hybrid: continue from the TMMC estimate */
+	  gsl_histogram *gtm = tmmc_dos();
+	  for(i=wanglandau_opt.truedosbins_given ? wanglandau_opt.truedosbins : 0;
+	      i<g->n;i++){
+	    if (gtm->bin[i] != 0.){ g->bin[i] = gtm->bin[i]; }
+	  }
+	  gsl_histogram_free(gtm);
+	}
+	lnf /= 2;
 	fprintf(stderr,"# steps=%20li | f=%12g | histogram is FLAT\n",
 		steps,lnf);
-	gsl_histogram_reset(h);
+	if (shd == NULL){
+	  gsl_histogram_reset(h);
+	}
+	else if (shared_dos_reduce_lnf(shd,&lnf)){
+	  shared_dos_reset(shd);
+	}
+	if (g2 != NULL){ dos2d_reset(g2); }
       }
       else {
 	fprintf(stderr, "# steps=%20li | f=%12g | histogram is NOT FLAT\n",
 		steps,lnf);
       }
-      output_dos(g,'l');
+      if (lead){
+	output_dos(g,'l');
+	if (g2 != NULL){ output_dos2d(0.,'l'); }
+      }
+      if (shd != NULL && lead){
+	shared_dos_unlead(shd);
+      }
+      if (wanglandau_opt.verbose){
+	(void) clock_gettime(CLOCK_MONOTONIC, &tnow);
+	fprintf(stderr,"# %.4g steps/s\n",(steps-steps0)/
+		((tnow.tv_sec-tstart.tv_sec)+1e-9*(tnow.tv_nsec-tstart.tv_nsec)));
+      }
     }
     
     /* stop criterion */
     if(steps % wanglandau_opt.steplimit == 0){
       fprintf(stderr,"maximun number of MC steps (%li) reached, exiting ...",
 	      wanglandau_opt.steplimit);
+      steplimit_reached = 1;
       break;
     }
 
   } /* end while */
+  (void) clock_gettime(CLOCK_MONOTONIC, &tnow);
+  {
+    double sec = (tnow.tv_sec-tstart.tv_sec)+1e-9*(tnow.tv_nsec-tstart.tv_nsec);
+    fprintf(stderr,"# %lu steps in %.3f s (%.4g steps/s)\n",
+	    steps-steps0,sec,(steps-steps0)/sec);
+  }
+  if (level == 0 && wanglandau_opt.production > 0){
+    production_run(vc,wk,n,step);
+  }
+  if (rs != NULL){
+    output_reservoir();
+  }
 
+  /* keep the current structure of walker 0 for the next refinement
+     level */
+  {
+    char *db = vrna_db_from_ptable(wk[0].pt);
+    strcpy(struc,db);
+    free(db);
+  }
+  if (sc != NULL){
+    loopcache_report(stderr,"state",sc);
+  }
+  if (lc != NULL){
+    loopcache_report(stderr,"loop",lc);
+  }
+  for(k=0;k<n;k++){
+    looptree_free(wk[k].lt);
+    looptree_free(wk[k].lth);
+    free(wk[k].pt);
+    if (k > 0){ gsl_rng_free(wk[k].r); }
+  }
+  free(wk);
+  if (nf != NULL){
+    fprintf(stderr,"# N-fold way: %lu events correspond to %.6g MC steps "
+	    "(%li move evaluations)\n",steps,nfold_time,nf->evals);
+    nfold_free(nf);
+    nf = NULL;
+  }
+  if (vch != NULL){
+    if (lch != NULL){ loopcache_report(stderr,"enthalpy",lch); }
+    vrna_fold_compound_free(vch);
+    vch = NULL;
+  }
   vrna_fold_compound_free(vc);
-  free(pt); 
   return;
 }
 
 
 /* ==== */
+/* multicanonical production run: the walkers continue with the final
+   ln g, which is no longer modified, and every step adds the
+   observables of the current structure to the averages of its bin.
+   They are recomputed only when the structure has changed. */
+static void
+production_run(vrna_fold_compound_t *vc,
+	       walker *wk,
+	       const int n,
+	       void (*step)(vrna_fold_compound_t *, walker *))
+{
+  int k;
+  long int t;
+  walker *w=NULL;
+  char *s = mfe_structure_RNA(wanglandau_opt.sequence);
+
+  pt_mfe = vrna_ptable(s);
+  free(s);
+  ob = observables_init(g->n,wanglandau_opt.len);
+  lnf = 0.;
+  for(k=0;k<n;k++){
+    observables_structure(wk[k].pt,pt_mfe,wk[k].obs);
+    wk[k].zobs = wk[k].zh;
+  }
+  fprintf(stderr,"# production run of %li steps with fixed ln g\n",
+	  wanglandau_opt.production);
+  for(t=0,k=0;t<wanglandau_opt.production;t++){
+    w = &wk[k];
+    k = (k+1 == n) ? 0 : k+1;
+    steps++;
+    step(vc,w);
+    maxbin = MAX2(maxbin,(int)w->b1);
+    if (w->zh != w->zobs){
+      observables_structure(w->pt,pt_mfe,w->obs);
+      w->zobs = w->zh;
+    }
+    observables_add(ob,w->b1,w->obs,w->pt);
+    if (rs != NULL){ reservoir_add(rs,w->b1,w->pt,w->e,w->r); }
+  }
+  output_observables();
+}
+
+/* ==== */
+/* TMMC estimate of ln g on the bins of g, anchored to g in the lowest
+   connected bin */
 static gsl_histogram *
-ini_histogram_uniform(const int n,
-		      const double min,
-		      const double max)
+tmmc_dos(void)
+{
+  int nest;
+  gsl_histogram *gtm = gsl_histogram_clone(g);
+
+  nest = tmmc_estimate(tm,gtm->bin);
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"TMMC estimate covers %d bins\n",nest);
+  }
+  return gtm;
+}
+
+/* ==== */
+/* one step of the standard walk: propose a random move and accept it
+   with probability min(1,g(E_old)/g(E_new)). trace (debug output),
+   frozen (keep ln g in the true DOS bins), shared (atomic updates of
+   a DOS shared with other processes) and joint (ln g per energy and
+   distance, or per enthalpy and entropy) are compile-time constants in
+   the variants below, s.t. their branches vanish from the production
+   step */
+static inline void __attribute__((always_inline))
+mc_step(vrna_fold_compound_t *vc,
+	walker *w,
+	const int trace,
+	const int frozen,
+	const int shared,
+	const int joint)
+{
+  short *pt = w->pt;
+  int e = w->e,enew,emove,inrange,nmoves,x2=0,y2=0,h2=0;
+  size_t b1 = w->b1,b2;
+  double dg;        /* g_b1 - g_b2 */
+  dos2d_cell *c1=NULL,*c2=NULL; /* current and proposed cell (joint) */
+  uint64_t hnew;    /* hash of the proposed structure */
+  move_str m;
+
+  /* make a random move */
+  m = get_random_move_pt(wanglandau_opt.sequence,pt,&nmoves,w->r);
+  /* structures seen before need not be evaluated */
+  hnew = w->zh ^ pair_key(abs(m.left),abs(m.right));
+  if (sc == NULL || !loopcache_get(sc,hnew,&enew)){
+    /* compute energy difference for this move */
+    emove = looptree_eval_move(w->lt,vc,pt,m.left,m.right);
+    /* evaluate energy of the new structure */
+    enew = e + emove;
+    if (sc != NULL){ loopcache_put(sc,hnew,enew); }
+  }
+  emove = enew - e;
+  if (trace && wanglandau_opt.debug){
+    fprintf(stderr,
+	    "random move: left %i right %i enew(%6.4f)=e(%6.4f)+emove(%6.4f)\n",
+	    m.left,m.right,(float)enew/100,(float)e/100,(float)emove/100);
+  }
+
+  /* ensure the new energy is within sampling range */
+  inrange = 1;
+  if (enew < ewin_lo){ /* below the sampling window */
+    inrange = 0;
+  }
+  else if (enew >= ebin_hi){
+    switch(wanglandau_opt.outofrange){
+    case RANGE_GROW:
+      grow_histograms((float)enew/100);
+      break;
+    case RANGE_REJECT:
+      inrange = 0;
+      break;
+    default:
+      fprintf(stderr,
+	      "New structure has energy %6.2f >= %6.2f (upper energy bound)\n",
+	      (float)enew/100,wanglandau_opt.max);
+      fprintf(stderr,"Please increase --bins or adjust --max! Exiting ...\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (inrange){
+    /* determine bin where the new structure goes */
+    b2 = energy_bin(enew);
+  }
+  else { /* out-of-range proposals count as rejected moves */
+    b2 = b1;
+  }
+
+  if (tm != NULL){
+    tmmc_update(tm,b1,b2,nmoves);
+  }
+
+  /* core MC steps: moves to bins with lower ln g are always
+     accepted, without drawing a random number */
+  if (joint){
+    /* a cell not entered before is as likely as the current one */
+    c1 = dos2d_find(g2,w->cx,w->cy);
+    c2 = c1;
+    if (inrange && joint == JOINT_DIST){
+      x2 = b2;
+      y2 = w->d + move_distance(pt_ref,m);
+      c2 = dos2d_find(g2,x2,y2);
+    }
+    else if (inrange){
+      h2 = w->eh + looptree_eval_move(w->lth,vch,pt,m.left,m.right);
+      x2 = hs_x(h2);
+      y2 = hs_y(h2,enew);
+      c2 = dos2d_find(g2,x2,y2);
+    }
+    dg = (c2 != NULL) ? c1->g - c2->g : 0.;
+  }
+  else {
+    dg = g->bin[b1] - g->bin[b2];
+  }
+
+  if (inrange && (dg >= 0. || next_log_uniform(w) <= dg) ) { /* accept & apply the move */
+    apply_move_pt(pt,m,&w->zh,(joint == JOINT_DIST) ? pt_ref : NULL,&w->d);
+    looptree_apply_move(w->lt,vc,pt,m.left,m.right);
+    if (joint == JOINT_HS){
+      looptree_apply_move(w->lth,vch,pt,m.left,m.right);
+      w->eh = h2;
+    }
+    if (joint){
+      if (c2 == NULL){ (void) dos2d_insert(g2,x2,y2,c1->g); }
+      w->cx = x2;
+      w->cy = y2;
+    }
+    if (trace && wanglandau_opt.debug){
+      print_str(stderr,pt);
+      fprintf(stderr, " %6.2f bin:%zu [A]\n", (float)enew/100,b2);
+    }
+    b1 = b2;
+    e = enew;
+  }
+  else { /* reject the move */
+    if (trace && wanglandau_opt.debug){
+      print_str(stderr,pt);
+      fprintf(stderr, " (%6.2f) bin:%zu [R]\n", (float)enew/100,b2);
+     }
+  }
+
+  /* update histograms g and h */
+  if(frozen && b1 < wanglandau_opt.truedosbins){
+    /* keep the true DOS values in the (0-based) bins below
+       truedosbins */
+    if (trace && wanglandau_opt.debug){
+      fprintf(stderr, "NOT UPDATING bin %zu\n",b1);
+    }
+  } else{
+    if (trace && wanglandau_opt.debug){
+      fprintf(stderr, "UPDATING bin %zu\n",b1); 
+    }
+    if (shared){
+      shared_add(&h->bin[b1],1.);
+      shared_add(&g->bin[b1],lnf);
+    }
+    else if (joint){
+      c1 = dos2d_find(g2,w->cx,w->cy);
+      c1->g += lnf;
+      c1->h += 1.;
+      h->bin[b1] += 1.;
+    }
+    else {
+      h->bin[b1] += 1.;
+      g->bin[b1] += lnf;
+    }
+  }
+  w->e = e;
+  w->b1 = b1;
+}
+
+/* ==== */
+/* step variants, selected once per stage in wl_montecarlo() */
+static void
+step_production(vrna_fold_compound_t *vc, walker *w)
+{
+  mc_step(vc,w,0,0,0,0);
+}
+
+static void
+step_frozen(vrna_fold_compound_t *vc, walker *w)
+{
+  mc_step(vc,w,0,1,0,0);
+}
+
+static void
+step_shared(vrna_fold_compound_t *vc, walker *w)
+{
+  mc_step(vc,w,0,0,1,0);
+}
+
+static void
+step_shared_frozen(vrna_fold_compound_t *vc, walker *w)
+{
+  mc_step(vc,w,0,1,1,0);
+}
+
+static void
+step_joint(vrna_fold_compound_t *vc, walker *w)
+{
+  mc_step(vc,w,0,0,0,JOINT_DIST);
+}
+
+static void
+step_hs(vrna_fold_compound_t *vc, walker *w)
+{
+  mc_step(vc,w,0,0,0,JOINT_HS);
+}
+
+/* debug output and/or verification of incremental energies */
+static void
+step_trace(vrna_fold_compound_t *vc, walker *w)
+{
+  if (wanglandau_opt.debug){
+    fprintf(stderr,"\n==================\n");
+    fprintf(stderr,"in while: lnf=%8.6f\n",lnf);
+    fprintf(stderr,"steps: %lu\n",steps);
+    fprintf(stderr,"current histogram g:\n");
+    gsl_histogram_fprintf(stderr,g,"%6.2f","%30.6f");
+    fprintf(stderr,"\n");
+    print_str(stderr,w->pt);
+    fprintf(stderr, " (%6.2f) bin:%zu\n",(float)w->e/100,w->b1);
+    /*  mtw_dump_pt(pt); */
+  }
+  if (nf != NULL){
+    nfold_step(vc,w);
+  }
+  else {
+    mc_step(vc,w,1,wanglandau_opt.truedosbins_given,shd != NULL,
+	    (g2 == NULL) ? 0 : ((vch != NULL) ? JOINT_HS : JOINT_DIST));
+  }
+  if (wanglandau_opt.verify){ /* verify incremental energies */
+    int eref = vrna_eval_structure_pt(vc,w->pt);
+    if (w->e != eref || (w->lt != NULL && looptree_energy(w->lt) != eref) ||
+	w->zh != structure_hash_pt(w->pt) ||
+	(pt_ref != NULL && w->d != bp_distance_pt(pt_ref,w->pt)) ||
+	(vch != NULL && (w->eh != vrna_eval_structure_pt(vch,w->pt) ||
+			 looptree_energy(w->lth) != w->eh))){
+      fprintf(stderr, "energy evaluation against vrna_eval_structure_pt() mismatch... HAVE %6.2f != %6.2f (SHOULD BE)\n",(float)w->e/100, (float)eref/100);
+      print_str(stderr,w->pt);
+      fprintf(stderr, "\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+/* ==== */
+/* rejection-free (N-fold way) step: the mean time the standard walk
+   would spend in the current structure is credited to g and h at
+   once, then the walk jumps to a neighbor chosen in proportion to its
+   acceptance probability */
+static void
+nfold_step(vrna_fold_compound_t *vc,
+	   walker *w)
+{
+  int k,demax=0;
+  double g_b1,q=0.,tau,u;
+  move_str m;
+
+  /* neighbors above the sampling range are handled as in mc_step(),
+     where each of them would be proposed eventually */
+  for(k=0;k<nf->n;k++){ demax = MAX2(demax,nf->de[k]); }
+  if (w->e+demax >= ebin_hi){
+    switch(wanglandau_opt.outofrange){
+    case RANGE_GROW:
+      grow_histograms((float)(w->e+demax)/100);
+      break;
+    case RANGE_REJECT:
+      break;
+    default:
+      fprintf(stderr,
+	      "New structure has energy %6.2f >= %6.2f (upper energy bound)\n",
+	      (float)(w->e+demax)/100,wanglandau_opt.max);
+      fprintf(stderr,"Please increase --bins or adjust --max! Exiting ...\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  /* acceptance probabilities of all neighbors; out-of-range
+     neighbors are rejected */
+  g_b1 = gsl_histogram_get(g,w->b1);
+  for(k=0;k<nf->n;k++){
+    nf->w[k] = 0.;
+    nf->bin[k] = w->b1;
+    if (w->e+nf->de[k] >= ebin_hi || w->e+nf->de[k] < ewin_lo){ continue; }
+    nf->bin[k] = energy_bin(w->e+nf->de[k]);
+    nf->w[k] = MIN2(exp(g_b1 - g->bin[nf->bin[k]]), 1.0);
+    q += nf->w[k];
+  }
+  if (q == 0.){
+    fprintf(stderr,"N-fold way: no neighbor of the current structure is within the sampling range\n");
+    fprintf(stderr,"Please increase --bins or adjust --max! Exiting ...\n");
+    exit(EXIT_FAILURE);
+  }
+  tau = (double)nf->n/q; /* mean # of steps until a move is accepted */
+  nfold_time += tau;
+
+  if (tm != NULL){ /* expected proposal counts over tau steps */
+    tm->v[w->b1] += tau;
+    for(k=0;k<nf->n;k++){ tmmc_count(tm,w->b1,nf->bin[k],tau); }
+  }
+  if (!(wanglandau_opt.truedosbins_given && w->b1 < wanglandau_opt.truedosbins)){
+    if (shd != NULL){
+      shared_add(&g->bin[w->b1],tau*lnf);
+      shared_add(&h->bin[w->b1],tau);
+    }
+    else {
+      g->bin[w->b1] += tau*lnf;
+      h->bin[w->b1] += tau;
+    }
+  }
+
+  /* choose the neighbor */
+  u = gsl_rng_uniform(w->r) * q;
+  for(k=0;k<nf->n-1;k++){
+    if ((u -= nf->w[k]) < 0.){ break; }
+  }
+  while (nf->w[k] == 0.){ k--; } /* guard against round-off */
+  m = nf->mv[k];
+  w->e += nf->de[k];
+  w->b1 = nf->bin[k];
+  apply_move_pt(w->pt,m,&w->zh,NULL,NULL);
+  nfold_update(nf,vc,wanglandau_opt.sequence,w->pt,m);
+  if(wanglandau_opt.debug){
+    print_str(stderr,w->pt);
+    fprintf(stderr, " %6.2f bin:%zu [N] tau=%g\n",(float)w->e/100,w->b1,tau);
+  }
+}
+
+/* ==== */
+/* append bins of the current top bin width at the high-energy end of
+   g, h and s s.t. energy en is covered */
+static void
+grow_histograms(const double en)
+{
+  size_t i,k;
+  const size_t n = g->n;
+  double width,edge,*range=NULL;
+
+  if (en < g->range[n]){ /* --max was below the top of the histogram */
+    wanglandau_opt.max = g->range[n];
+    build_bin_lookup();
+    return;
+  }
+  width = g->range[n] - g->range[n-1];
+  k = (size_t)floor((en - g->range[n])/width) + 1;
+  k = MAX2(k, n/10); /* grow in chunks to keep reallocations rare */
+
+  range = (double*)calloc(n+k+1, sizeof(double));
+  assert(range!=NULL);
+  memcpy(range, g->range, (n+1)*sizeof(double));
+  for(i=1;i<=k;i++){
+    range[n+i] = g->range[n] + i*width;
+  }
+
+  /* new bins of g start from the estimate at the current high-energy
+     edge, so the walk is not trapped in them; before the first visit
+     all of g is still 0 (no --truedosbins), and so are the new bins */
+  edge = (maxbin >= 0) ? g->bin[maxbin] : 0.;
+  g = extend_histogram(g,range,n+k,edge);
+  s = extend_histogram(s,range,n+k,0.);
+  h = extend_histogram(h,range,n+k,0.);
+  /* restart the flatness check, s.t. new bins are not compared against
+     visit counts accumulated before they existed */
+  gsl_histogram_reset(h);
+
+  extend_layout(range[n+k]); /* keep the finest layout in sync */
+  if (tm != NULL){ tmmc_resize(tm,n+k); }
+  if (hl != NULL){ hll_resize(hl,n+k); }
+  if (ob != NULL){ observables_resize(ob,n+k); }
+  if (rs != NULL){ reservoir_resize(rs,n+k); }
+  wanglandau_opt.bins = n+k;
+  wanglandau_opt.max  = range[n+k];
+  build_bin_lookup();
+  fprintf(stderr,"# steps=%20li | grew histogram to %d bins (%6.2f -- %6.2f)\n",
+	  steps,wanglandau_opt.bins,range[0],range[n+k]);
+  free(range);
+}
+
+/* ==== */
+/* map integer energies (dcal/mol) in the sampling range to bins of g,
+   s.t. the MC loop needs neither float conversions nor binary
+   searches; the mapping is the one of gsl_histogram_find() on
+   (float)e/100 */
+static void
+build_bin_lookup(void)
+{
+  int k;
+  size_t b;
+
+  ebin_lo = (int)floor(g->range[0]*100) - 1;
+  ebin_hi = (int)ceil(wanglandau_opt.max*100) + 1;
+  while ((float)(ebin_hi-1)/100 >= wanglandau_opt.max){ ebin_hi--; }
+  free(ebin);
+  ebin = (int*)calloc(ebin_hi-ebin_lo, sizeof(int));
+  assert(ebin!=NULL);
+  ewin_lo = ebin_hi;
+  for(k=ebin_hi-1;k>=ebin_lo;k--){
+    ebin[k-ebin_lo] = gsl_histogram_find(g,(float)k/100,&b) ? -1 : (int)b;
+    if (ebin[k-ebin_lo] >= 0){ ewin_lo = k; }
+  }
+}
+
+/* ==== */
+/* move pt into the sampling range [ewin_lo,ebin_hi) by a Metropolis
+   walk at 1 kcal/mol on the distance to the range, s.t. windows far
+   from the start structure can be sampled; returns the energy of the
+   structure reached */
+static int
+enter_window(vrna_fold_compound_t *vc,
+	     short *pt,
+	     int e,
+	     const gsl_rng *rng)
+{
+  long int i;
+  int enew,d,dnew;
+  move_str m;
+
+  d = (e < ewin_lo) ? ewin_lo-e : e-ebin_hi+1;
+  for(i=0; d > 0 && i<wanglandau_opt.pilotsteps; i++){
+    m = get_random_move_pt(wanglandau_opt.sequence,pt,NULL,rng);
+    enew = e + vrna_eval_move_pt(vc,pt,m.left,m.right);
+    dnew = (enew < ewin_lo) ? ewin_lo-enew : (enew >= ebin_hi) ? enew-ebin_hi+1 : 0;
+    if (dnew <= d || gsl_rng_uniform(rng) < exp((double)(d-dnew)/100)){
+      apply_move_pt(pt,m,NULL,NULL,NULL);
+      e = enew;
+      d = dnew;
+    }
+  }
+  if (d > 0){
+    fprintf(stderr,"No structure within the sampling range %6.2f -- %6.2f found after %li steps\n",
+	    g->range[0],wanglandau_opt.max,wanglandau_opt.pilotsteps);
+    fprintf(stderr,"Please increase --pilotsteps or adjust --elow/--ehigh! Exiting ...\n");
+    exit(EXIT_FAILURE);
+  }
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"entered sampling range after %li steps at %6.2f\n",
+	    i,(double)e/100);
+  }
+  return e;
+}
+
+/* ==== */
+/* bin of energy e < ebin_hi */
+static inline int
+energy_bin(const int e)
+{
+  int b = (e < ebin_lo) ? -1 : ebin[e-ebin_lo];
+
+  if (b < 0){
+    fprintf(stderr,"Energy %6.2f is below the sampling range (%6.2f)\n",
+	    (float)e/100,g->range[0]);
+    exit(EXIT_FAILURE);
+  }
+  return b;
+}
+
+/* ==== */
+/* ln of a uniform random number in (0,1); numbers are drawn in
+   batches to keep the RNG and log() out of the acceptance test */
+static inline double
+next_log_uniform(walker *w)
 {
+  int k;
+
+  if (w->lnu_pos == LNU_BATCH){
+    for(k=0;k<LNU_BATCH;k++){ w->lnu[k] = log(gsl_rng_uniform_pos(w->r)); }
+    w->lnu_pos = 0;
+  }
+  return w->lnu[w->lnu_pos++];
+}
+
+/* ==== */
+/* cell of g2 (--hs) of a structure with enthalpy eh and free energy e
+   at --Temp (dcal/mol); its entropy is (eh-e)/T */
+static inline int
+hs_x(const int eh)
+{
+  return (int)floor(eh/(100.*wanglandau_opt.hres)) + HS_OFFSET;
+}
+
+static inline int
+hs_y(const int eh,
+     const int e)
+{
+  return (int)floor(10.*(eh-e)/((wanglandau_opt.T+K0)*wanglandau_opt.sres))
+    + HS_OFFSET;
+}
+
+/* ==== */
+/* enthalpy (kcal/mol) and entropy (cal/(mol K)) at the cell centers */
+static inline double
+hs_h(const int x)
+{
+  return (x - HS_OFFSET + 0.5)*wanglandau_opt.hres;
+}
+
+static inline double
+hs_s(const int y)
+{
+  return (y - HS_OFFSET + 0.5)*wanglandau_opt.sres;
+}
+
+/* ==== */
+/* bin of g holding the free energy at --Temp of cell c, or -1 */
+static int
+hs_bin(const dos2d_cell *c)
+{
+  size_t i;
+  const double e = hs_h(dos2d_x(c)) -
+    (wanglandau_opt.T+K0)*hs_s(dos2d_y(c))/1000.;
+
+  if (gsl_histogram_find(g,e,&i) != GSL_SUCCESS){ return -1; }
+  return (int)i;
+}
+
+/* ==== */
+/* returns a copy of x with ranges range[0..n]; bins beyond those of x
+   are set to fill; x is freed */
+static gsl_histogram *
+extend_histogram(gsl_histogram *x,
+		 const double *range,
+		 const size_t n,
+		 const double fill)
+{
+  size_t i;
   gsl_histogram *a = gsl_histogram_alloc(n);
-  gsl_histogram_set_ranges_uniform(a,min,max);
+
+  gsl_histogram_set_ranges(a,range,n+1);
+  for(i=0;i<n;i++){
+    a->bin[i] = (i < x->n) ? x->bin[i] : fill;
+  }
+  gsl_histogram_free(x);
   return a;
 }
 
@@ -487,25 +1760,6 @@ histogram_is_flat(const gsl_histogram *z)
   return is_flat;
 }
 
-/* ==== */
-/* Z = \sum{E} g(e)*e^{-E-kT} */
-static double
-partition_function(const gsl_histogram *y)
-{
-  int i;
-  float T;
-  double kT,Z=0.;
-  const size_t n = y->n; /* nr of bins */
-
-  T = 273.15 + wanglandau_opt.T;
-  kT  = 0.00198717*4.16*T;
-  
-  for(i=0;i<n;i++){
-    Z += y->bin[i] * exp(-1*y->bin[i]/kT);
-  }
-  return Z;
-}
-
 /* ==== */
 static gsl_histogram *
 scale_dos(gsl_histogram *y)
@@ -513,7 +1767,12 @@ scale_dos(gsl_histogram *y)
   int i,maxbin;
   size_t bins;
   double  maxval=-1., sum=0., x=0, factor=0., GZero=0,  exp_G_norm=0.;
+  double shift;
   const size_t n = y->n; /* nr of bins */
+  const int i0 = wanglandau_opt.truedosbins-1; /* lowest bin to shift */
+
+  /* windows above the mfe are normalized by RNAwl-merge */
+  if (!window_exact){ return y; }
   
   /* FIRST: scale it via the ground state */
   /* ln[gn(E)] = ln[g(E)]-ln[g(Egs)]+ln[Q] */
@@ -526,11 +1785,38 @@ scale_dos(gsl_histogram *y)
   for(i=0;i<1;i++){
     factor += gsl_histogram_get(s,i);
   }
+  shift = log(factor)-GZero;
+
+  /* alternatively, make sum_E g(E) the exact total # of structures,
+     or fit to both: least squares over one equation per exact bin
+     (ln g + shift = ln of its # of structures; with --truedosbins
+     these bins are not shifted, s.t. they ask for shift 0) and one for
+     the total count */
+  if (wanglandau_opt.normalize != NORM_BIN){
+    double c = count_shift(y,i0);
+    if (isinf(c)){
+      fprintf(stderr,"normalization by the total # of structures failed, using the lowest bin\n");
+    }
+    else if (wanglandau_opt.normalize == NORM_COUNT){
+      shift = c;
+    }
+    else {
+      int nex=0;
+      double sum=0.;
+      for (i=0;i<wanglandau_opt.truedosbins;i++){
+	if (s->bin[i] <= 0. || (y->bin[i] == 0. && i > 0)){ continue; }
+	sum += log(s->bin[i]) - y->bin[i];
+	nex++;
+      }
+      shift = (sum + c)/(nex+1);
+    }
+  }
+
   /* subtract g[0] [ln(g(Egs))] from each entry to get smaller numbers
      and add scaling factor*/
-  for (i=wanglandau_opt.truedosbins-1;i<n;i++){
+  for (i=i0;i<n;i++){
     if(y->bin[i] == 0.){ continue;}
-    else{y->bin[i] += log(factor)-GZero;}
+    else{y->bin[i] += shift;}
   }
   
   /* exponentiate to get effective DOS */
@@ -540,11 +1826,42 @@ scale_dos(gsl_histogram *y)
   }
   */
   
-  output_dos(y,'s');  
-  
   return y;
 }
 
+/* ==== */
+/* constant scale_dos() has added to the populated bins of g to
+   obtain x, s.t. it can be applied to g2 as well */
+static double
+scale_shift(const gsl_histogram *x)
+{
+  int i;
+
+  for(i=maxbin;i>=0;i--){
+    if (g->bin[i] != 0.){ return x->bin[i] - g->bin[i]; }
+  }
+  return 0.;
+}
+
+/* ==== */
+/* shift of ln g in bins >= i0 s.t. sum_E g(E) is the exact total # of
+   structures; the bins below i0 hold true DOS values and stay fixed.
+   Returns INFINITY if they alone exceed the total */
+static double
+count_shift(const gsl_histogram *y,
+	    const int i0)
+{
+  double lnA = -INFINITY,lnB;
+
+  if (i0 > 0){
+    lnA = dos_log_sum(y->range,y->bin,i0,0.);
+  }
+  lnB = dos_log_sum(y->range+i0,y->bin+i0,y->n-i0,0.);
+  if (lnA >= exact_lnN){ return INFINITY; }
+  /* ln(N-A) - ln B */
+  return exact_lnN + log1p(-exp(lnA-exact_lnN)) - lnB;
+}
+
 /* ==== */
 static void
 output_dos(const gsl_histogram *x, const char T)
@@ -552,6 +1869,7 @@ output_dos(const gsl_histogram *x, const char T)
   int i,fnlen;
   FILE *dos_fp=NULL;
   char *dos_fn=NULL, *lDoS_suffix="lDoS", *sDoS_suffix="sDoS";
+  char *tDoS_suffix="tDoS", *cDoS_suffix="cDoS";
   char s[50];
   double val,lo,hi;
  
@@ -570,6 +1888,12 @@ output_dos(const gsl_histogram *x, const char T)
   case 's':  /* output scaled g, eg for in-process convergence checks */
     strcat(dos_fn, sDoS_suffix);
     break;
+  case 't':  /* output scaled TMMC estimate of g */
+    strcat(dos_fn, tDoS_suffix);
+    break;
+  case 'c':  /* output ln of the # of distinct structures seen */
+    strcat(dos_fn, cDoS_suffix);
+    break;
   default:
     fprintf (stderr, "%s:%d output_dos(): No handler for type %c",
 	     __FILE__, __LINE__, T);
@@ -580,7 +1904,43 @@ output_dos(const gsl_histogram *x, const char T)
   fprintf(dos_fp, "# estimated DOS after %li steps\n",steps);
   fprintf(dos_fp, "# sampling range: %6.2f -- %6.2f\n",
 	  gsl_histogram_min(g),gsl_histogram_max(g));
-  fprintf(dos_fp, "# bin resolution: %g\n",wanglandau_opt.res);
+  if (wanglandau_opt.elow_given || wanglandau_opt.ehigh_given){
+    fprintf(dos_fp, "# energy window: %6.2f -- %6.2f\n",
+	    gsl_histogram_min(g),wanglandau_opt.max);
+  }
+  if (wanglandau_opt.binedges != NULL){
+    fprintf(dos_fp, "# bin edges: %s\n",wanglandau_opt.binedges);
+  }
+  else {
+    fprintf(dos_fp, "# bin resolution: %g\n",wanglandau_opt.res);
+  }
+  if (wanglandau_opt.refine > 0){
+    fprintf(dos_fp, "# refinement level: %d of %d (%d bins)\n",
+	    level,wanglandau_opt.refine,wanglandau_opt.bins);
+  }
+  if (wanglandau_opt.autorange){
+    fprintf(dos_fp, "# auto range: %d bins up to %6.2f (pilot %li steps, max %6.2f; greedy max %6.2f)\n",
+	    wanglandau_opt.bins,wanglandau_opt.max,wanglandau_opt.pilotsteps,
+	    pilot_emax,greedy_emax);
+  }
+  if (wanglandau_opt.initdos != NULL){
+    fprintf(dos_fp, "# initial estimate: %s (f=%g)\n",
+	    wanglandau_opt.initdos,wanglandau_opt.finit);
+  }
+  if (converged){
+    fprintf(dos_fp, "# %s\n",convergence);
+  }
+  if ((T == 's' || T == 't') && wanglandau_opt.normalize != NORM_BIN){
+    fprintf(dos_fp, "# normalized by the exact total # of structures%s\n",
+	    (wanglandau_opt.normalize == NORM_FIT) ? " and lowest bin" : "");
+  }
+  if (T == 's' && have_exact_G){
+    fprintf(dos_fp, "# ensemble free energy: %8.3f kcal/mol (exact %8.3f)\n",
+	    dos_G,exact_G);
+  }
+  if (T == 's' && have_exact_lnN){
+    fprintf(dos_fp, "# ln(# structures): %g (exact %g)\n",dos_lnN,exact_lnN);
+  }
 
   /* loop over histogram g */
   for (i=0;i<=maxbin;i++){
@@ -594,6 +1954,366 @@ output_dos(const gsl_histogram *x, const char T)
   return;
 }
 
+/* ==== */
+/* exact DOS by dynamic programming, binned like the sampled one */
+static void
+output_exact_dos(void)
+{
+  char *fn=NULL;
+  double en;
+  FILE *fp=NULL;
+  dosvec *v = exact_dos(wanglandau_opt.sequence,wanglandau_opt.T);
+
+  en = (double)v->e[v->n-1]/100;
+  if (en >= gsl_histogram_max(g) && wanglandau_opt.outofrange == RANGE_GROW){
+    grow_histograms(en);
+  }
+
+  fn = (char*)calloc(strlen(out_prefix)+16, sizeof(char));
+  assert(fn!=NULL);
+  sprintf(fn,"%sexact.ref",out_prefix);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# exact DOS (dynamic programming): energy and # of structures\n");
+  fprintf(fp, "# sampling range: %6.2f -- %6.2f\n",
+	  gsl_histogram_min(g),gsl_histogram_max(g));
+  if (wanglandau_opt.binedges != NULL){
+    fprintf(fp, "# bin edges: %s\n",wanglandau_opt.binedges);
+  }
+  else {
+    fprintf(fp, "# bin resolution: %g\n",wanglandau_opt.res);
+  }
+  if ((double)v->e[0]/100 < gsl_histogram_min(g) ||
+      (double)v->e[v->n-1]/100 >= gsl_histogram_max(g)){
+    fprintf(fp, "# structures outside the sampling range are not counted\n");
+  }
+  dosvec_fprintf(fp,v,g->range,g->n);
+  fclose(fp);
+  fprintf(stderr,"# exact DOS: %d energies, mfe %6.2f, written to %s\n",
+	  v->n,(double)v->e[0]/100,fn);
+
+  free(fn);
+  dosvec_free(v);
+}
+
+/* ==== */
+/* joint DOS over energy and base-pair distance (or enthalpy and
+   entropy), ln g shifted by shift; with the scaled one ('s'), the free
+   energy of each distance class at --Temp is written to a .dland
+   file */
+static void
+output_dos2d(const double shift,
+	     const char T)
+{
+  int k,d,n=wanglandau_opt.len;
+  char fn[1024];
+  double lo,hi,x,beta,*m=NULL,*z=NULL;
+  dos2d_cell **c = dos2d_sorted(g2);
+  FILE *fp=NULL;
+
+  snprintf(fn,sizeof(fn),"%s%li.%c2DoS",out_prefix,steps,T);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# estimated joint DOS after %li steps\n",steps);
+  if (vch != NULL){
+    fprintf(fp, "# enthalpy resolution %g kcal/mol, entropy resolution %g cal/(mol K), %lu cells\n",
+	    wanglandau_opt.hres,wanglandau_opt.sres,(unsigned long)g2->n);
+    fprintf(fp, "# enthalpy\tentropy\tln g\n");
+    for(k=0;c[k]!=NULL;k++){
+      fprintf(fp,"%8.2f\t%8.2f\t%20.6f\n",
+	      hs_h(dos2d_x(c[k])),hs_s(dos2d_y(c[k])),c[k]->g+shift);
+    }
+    fclose(fp);
+    free(c);
+    return;
+  }
+  fprintf(fp, "# distance to the %s structure, %lu cells\n",
+	  (wanglandau_opt.distance == DIST_MFE) ? "mfe" : "start",
+	  (unsigned long)g2->n);
+  fprintf(fp, "# energy\tdistance\tln g\n");
+  for(k=0;c[k]!=NULL;k++){
+    gsl_histogram_get_range(g,dos2d_x(c[k]),&lo,&hi);
+    fprintf(fp,"%6.2f\t%4d\t%20.6f\n",lo+(hi-lo)/2,dos2d_y(c[k]),c[k]->g+shift);
+  }
+  fclose(fp);
+
+  if (T == 's'){
+    /* F(d) = -kT ln sum_E g(E,d) exp(-E/kT) */
+    beta = 1000./(GASCONST*(wanglandau_opt.T+K0));
+    m = (double*)malloc((n+1)*sizeof(double));
+    z = (double*)calloc(n+1, sizeof(double));
+    assert(m!=NULL); assert(z!=NULL);
+    for(d=0;d<=n;d++){ m[d] = -INFINITY; }
+    for(k=0;c[k]!=NULL;k++){
+      gsl_histogram_get_range(g,dos2d_x(c[k]),&lo,&hi);
+      x = c[k]->g + shift - beta*(lo+hi)/2;
+      if (x > m[dos2d_y(c[k])]){ m[dos2d_y(c[k])] = x; }
+    }
+    for(k=0;c[k]!=NULL;k++){
+      gsl_histogram_get_range(g,dos2d_x(c[k]),&lo,&hi);
+      d = dos2d_y(c[k]);
+      z[d] += exp(c[k]->g + shift - beta*(lo+hi)/2 - m[d]);
+    }
+    snprintf(fn,sizeof(fn),"%s%li.dland",out_prefix,steps);
+    if ((fp = fopen(fn, "w")) == NULL){
+      fprintf(stderr, "Cannot open %s for writing\n", fn);
+      exit(EXIT_FAILURE);
+    }
+    fprintf(fp, "# free energy (kcal/mol) per distance class at %g C after %li steps\n",
+	    wanglandau_opt.T,steps);
+    for(d=0;d<=n;d++){
+      if (z[d] == 0.){ continue; }
+      fprintf(fp,"%4d\t%12.4f\n",d,-(m[d]+log(z[d]))/beta);
+    }
+    fclose(fp);
+    free(m);
+    free(z);
+  }
+  free(c);
+}
+
+/* ==== */
+/* thermodynamics on the --thermo grid from the cells of g2 (--hs),
+   with ln g shifted by shift */
+static void
+thermo_hs(const double shift)
+{
+  int k;
+  dos2d_cell **c = dos2d_sorted(g2);
+  double *H = (double*)malloc(g2->n*sizeof(double));
+  double *S = (double*)malloc(g2->n*sizeof(double));
+  double *lg = (double*)malloc(g2->n*sizeof(double));
+  assert(H!=NULL); assert(S!=NULL); assert(lg!=NULL);
+
+  for(k=0;c[k]!=NULL;k++){
+    H[k] = hs_h(dos2d_x(c[k]));
+    S[k] = hs_s(dos2d_y(c[k]));
+    lg[k] = c[k]->g + shift;
+  }
+  thermo_compute_hs(th,H,S,lg,k);
+  free(H);
+  free(S);
+  free(lg);
+  free(c);
+}
+
+/* ==== */
+/* per-bin averages of the production run (.obs), pairing
+   probabilities (.pprof) and canonical averages on the temperature
+   grid, reweighted with the scaled ln g (.obsT) */
+static void
+output_observables(void)
+{
+  char fn[1024];
+  FILE *fp=NULL;
+  gsl_histogram *gcp=NULL;
+
+  if (g2 != NULL){
+    dos2d_project(g2,g->bin,g->n,(vch != NULL) ? hs_bin : NULL);
+  }
+  gcp = gsl_histogram_clone(g);
+  scale_dos(gcp);
+
+  snprintf(fn,sizeof(fn),"%s%li.obs",out_prefix,steps);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# per-bin averages of the production run (%li steps)\n",
+	  wanglandau_opt.production);
+  observables_fprintf(fp,ob,gcp->range);
+  fclose(fp);
+
+  snprintf(fn,sizeof(fn),"%s%li.pprof",out_prefix,steps);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  observables_fprintf_pairing(fp,ob,gcp->range);
+  fclose(fp);
+
+  snprintf(fn,sizeof(fn),"%s%li.obsT",out_prefix,steps);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# canonical averages, reweighted with the scaled DOS\n");
+  observables_canonical(fp,ob,gcp->range,gcp->bin,th->T,th->n);
+  fclose(fp);
+  gsl_histogram_free(gcp);
+}
+
+/* ==== */
+/* sampled structures of each bin (.rsv) */
+static void
+output_reservoir(void)
+{
+  char fn[1024];
+  FILE *fp=NULL;
+
+  snprintf(fn,sizeof(fn),"%s%li.rsv",out_prefix,steps);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# up to %d structures per bin, sampled uniformly from the visits after %li steps\n",
+	  rs->k,steps);
+  fprintf(fp, "%s\n",wanglandau_opt.sequence);
+  reservoir_fprintf(fp,rs,g->range);
+  fclose(fp);
+}
+
+/* ==== */
+/* thermodynamic quantities of the DOS estimate x over the temperature
+   grid, as computed at the last crosscheck */
+static void
+output_thermo(const gsl_histogram *x)
+{
+  char fn[1024];
+  FILE *fp=NULL;
+
+  snprintf(fn,sizeof(fn),"%s%li.thermo",out_prefix,steps);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# thermodynamics of the estimated DOS after %li steps\n",steps);
+  fprintf(fp, "# sampling range: %6.2f -- %6.2f\n",
+	  gsl_histogram_min(x),gsl_histogram_max(x));
+  thermo_fprintf(fp,th);
+  fclose(fp);
+}
+
+/* ==== */
+/* relative error of the scaled estimate x w.r.t. the reference DOS:
+   per-bin errors go to an .eDoS file, mean and max error are appended
+   to the error trajectory; returns the mean error */
+static double
+reference_error(const gsl_histogram *x)
+{
+  int i,cnt;
+  const int n = maxbin+1;
+  double mean,max,*e=NULL,*err=NULL;
+  char fn[1024];
+  FILE *fp=NULL;
+
+  e   = (double*)calloc(n, sizeof(double));
+  err = (double*)calloc(n, sizeof(double));
+  assert(e!=NULL); assert(err!=NULL);
+  for(i=0;i<n;i++){
+    e[i] = (x->range[i]+x->range[i+1])/2;
+  }
+  cnt = dos_relative_error(ref,e,x->bin,n,err,&mean,&max);
+
+  snprintf(fn,sizeof(fn),"%s%li.eDoS",out_prefix,steps);
+  if ((fp = fopen(fn, "w")) == NULL){
+    fprintf(stderr, "Cannot open %s for writing\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# relative error of ln g w.r.t. %s after %li steps\n",
+	  wanglandau_opt.refdos,steps);
+  for(i=0;i<n;i++){
+    if (err[i] < 0.){ continue; }
+    fprintf(fp,"%6.2f\t%20.6f\n",e[i],err[i]);
+  }
+  fclose(fp);
+
+  fprintf(err_fp, "%20li %12.6g %12.6g %6d\n",steps,mean,max,cnt);
+  fflush(err_fp);
+  fprintf(stderr,"relative error: mean %g, max %g (%d bins) ",mean,max,cnt);
+  free(e);
+  free(err);
+  return (cnt > 0) ? mean : HUGE_VAL;
+}
+
+/* ==== */
+/* compare the scaled estimate x with the one of the previous
+   crosscheck and, if y != NULL, with the (scaled) TMMC estimate y, over
+   the bins visited in both; the normalization bin and the true DOS
+   bins are left out. The level has converged once the max change and
+   the max deviation from y are within --tolerance at two successive
+   crosschecks */
+static void
+check_convergence(const gsl_histogram *x,
+		  const gsl_histogram *y)
+{
+  size_t i;
+  int cnt=0;
+  double d,dmax=0.,sum=0.,dtm=0.;
+  const size_t i0 = wanglandau_opt.truedosbins_given ?
+    MAX2(wanglandau_opt.truedosbins,1) : 1;
+
+  if (gprev != NULL && gprev->n == x->n){
+    for(i=i0;i<x->n;i++){
+      if (x->bin[i] == 0. || gprev->bin[i] == 0.){ continue; }
+      d = fabs(x->bin[i]-gprev->bin[i]);
+      dmax = MAX2(dmax,d);
+      sum += d*d;
+      cnt++;
+      if (y != NULL && y->bin[i] != 0.){
+	dtm = MAX2(dtm,fabs(x->bin[i]-y->bin[i]));
+      }
+    }
+  }
+  if (gprev != NULL){ gsl_histogram_free(gprev); }
+  gprev = gsl_histogram_clone(x);
+  if (cnt == 0){ /* nothing to compare (yet) */
+    stable = 0;
+    return;
+  }
+
+  fprintf(stderr,"change of ln g: max %g, rms %g ",dmax,sqrt(sum/cnt));
+  if (y != NULL){
+    fprintf(stderr,"(TMMC deviation %g) ",dtm);
+  }
+  stable = (dmax <= wanglandau_opt.tolerance &&
+	    dtm <= wanglandau_opt.tolerance) ? stable+1 : 0;
+  if (stable >= 2){
+    converged = 1;
+    if (y != NULL){
+      snprintf(convergence,sizeof(convergence),
+	       "converged after %li steps: max change of ln g %g (rms %g), max deviation from TMMC %g <= tolerance %g",
+	       steps,dmax,sqrt(sum/cnt),dtm,wanglandau_opt.tolerance);
+    }
+    else {
+      snprintf(convergence,sizeof(convergence),
+	       "converged after %li steps: max change of ln g %g (rms %g) <= tolerance %g",
+	       steps,dmax,sqrt(sum/cnt),wanglandau_opt.tolerance);
+    }
+  }
+}
+
+/* ==== */
+/* ensemble free energy and total # of structures implied by the
+   scaled estimate x, compared with the exact values; ends the level if
+   the deviations are within --pf-tolerance and --count-tolerance
+   (whichever are given) */
+static void
+check_invariants(const gsl_histogram *x)
+{
+  const double beta = 1000./(GASCONST*(wanglandau_opt.T+K0));
+  double dG,dN;
+
+  dos_G = -dos_log_sum(x->range,x->bin,maxbin+1,beta)/beta;
+  dos_lnN = dos_log_sum(x->range,x->bin,maxbin+1,0.);
+  dG = have_exact_G ? dos_G-exact_G : 0.;
+  dN = have_exact_lnN ? dos_lnN-exact_lnN : 0.;
+  if (have_exact_G){ fprintf(stderr,"dG=%g ",dG); }
+  if (have_exact_lnN){ fprintf(stderr,"d(ln N)=%g ",dN); }
+  if ((wanglandau_opt.pftol > 0. || wanglandau_opt.counttol > 0.) &&
+      (wanglandau_opt.pftol == 0. || fabs(dG) <= wanglandau_opt.pftol) &&
+      (wanglandau_opt.counttol == 0. || fabs(dN) <= wanglandau_opt.counttol)){
+    converged = 1;
+    snprintf(convergence,sizeof(convergence),
+	     "converged after %li steps: ensemble free energy off by %g kcal/mol, ln(# structures) off by %g",
+	     steps,dG,dN);
+  }
+}
+
 /* ==== */
 void
 sighandler (int signum)
@@ -614,6 +2334,28 @@ wanglandau_free_memory(void)
   free(wanglandau_opt.sequence);
   free(wanglandau_opt.structure);
   free(wanglandau_opt.basename);
+  free(wanglandau_opt.initdos);
+  free(wanglandau_opt.binedges);
+  free(wanglandau_opt.shareddos);
+  free(layout);
+  tmmc_free(tm);
+  hll_free(hl);
+  thermo_free(th);
+  dos2d_free(g2);
+  free(pt_ref);
+  loopcache_free(lch);
+  observables_free(ob);
+  reservoir_free(rs);
+  free(pt_mfe);
+  if (gprev != NULL){ gsl_histogram_free(gprev); }
+  free_dos_file(ref);
+  if (err_fp != NULL){ fclose(err_fp); }
+  free(wanglandau_opt.refdos);
+  free(wanglandau_opt.thermo);
+  free(wanglandau_opt.tgrid);
+  free(ebin);
+  loopcache_free(sc);
+  loopcache_free(lc);
   free(out_prefix);
   dealloc_gengetopt();
   return;
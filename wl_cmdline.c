@@ -32,30 +32,65 @@ const char *gengetopt_args_info_usage = "Usage: " CMDLINE_PARSER_PACKAGE " [OPTI
 const char *gengetopt_args_info_description = "";
 
 const char *gengetopt_args_info_help[] = {
-  "  -h, --help                 Print help and exit",
-  "  -V, --version              Print version and exit",
+  "  -h, --help                    Print help and exit",
+  "  -V, --version                 Print version and exit",
   "\nGeneral options:",
-  "  -b, --bins=INT             Number of (equidistant) histogram bins  \n                               (default=`100')",
-  "  -c, --checksteps=LONGLONG  Number of Wang-Landau steps before histogram is \n                               checked for flatness  (default=`1000000')",
-  "      --elow=DOUBLE          Lower limit of sampling window (currently n/a)",
-  "      --ehigh=DOUBLE         Upper limit of sampling window (currently n/a)",
-  "      --flat=FLOAT           Flatness criterion for the histogram  \n                               (default=`0.8')",
-  "      --info                 Show settings  (default=off)",
-  "  -m, --max=DOUBLE           Upper energy bound for sampling",
-  "  -f, --mod=DOUBLE           Final value of Wang-Landau modification factor",
-  "  -n, --norm=INT             Number of bins used for normalization",
-  "  -r, --resolution=DOUBLE    Sampling resolution (histogram bin width)  \n                               (default=`0.5')",
-  "  -l, --steplimit=LONGLONG   Maximum number of MC steps to perform  \n                               (default=`100000000')",
-  "  -S, --seed=LONG            Seed for random number generation",
-  "  -T, --Temp=FLOAT           Simulation temperature in Celsius (currently n/a)",
-  "  -t, --truedosbins=INT      Number of bins at the lower range of the energy\n                               spectrum that get overwritten by effective true \n                               DOS values (as computed by\n                               RNAsubopt)",
-  "  -v, --verbose              Verbose output  (default=off)",
-  "  -d, --debug                Debugging output  (default=off)",
+  "  -a, --auto                    Determine sampling range and number of bins by \n                                  a short pilot run  (default=off)",
+  "  -b, --bins=INT                Number of (equidistant) histogram bins  \n                                  (default=`100')",
+  "      --binedges=STRING         Read (non-uniform) histogram bin edges from \n                                  file",
+  "  -c, --checksteps=LONGLONG     Number of Wang-Landau steps before histogram is \n                                  checked for flatness  (default=`1000000')",
+  "      --distance=STRING         Joint DOS over energy and base-pair distance to \n                                  the start or mfe structure (start|mfe)",
+  "      --elow=DOUBLE             Lower limit of the sampling window; structures \n                                  below it are never visited",
+  "      --ehigh=DOUBLE            Upper limit of the sampling window (like --max, \n                                  but proposals above it are always rejected)",
+  "      --count-tolerance=DOUBLE  Stop when ln of the total # of structures of \n                                  the scaled DOS is within this value of the \n                                  exact count  (default=`0')",
+  "      --exact                   Compute the exact DOS by dynamic programming \n                                  (short sequences) and write it as .sDoS \n                                  instead of sampling  (default=off)",
+  "      --flat=FLOAT              Flatness criterion for the histogram  \n                                  (default=`0.8')",
+  "      --gamma0=DOUBLE           Initial SAMC gain factor  (default=`1.0')",
+  "      --hll=INT                 Count distinct structures per bin with \n                                  HyperLogLog sketches of 2^hll registers, 0 \n                                  disables them  (default=`0')",
+  "      --hres=DOUBLE             Enthalpy resolution of --hs (kcal/mol)  \n                                  (default=`1.0')",
+  "      --hs                      Joint DOS over enthalpy and entropy, from which \n                                  the thermodynamics at any temperature follow \n                                  (see --thermo)  (default=off)",
+  "      --info                    Show settings  (default=off)",
+  "      --init-dos=STRING         Initialize the DOS estimate from a previous \n                                  .lDoS/.sDoS file",
+  "      --init-mod=DOUBLE         Initial value of Wang-Landau modification \n                                  factor  (default=`1.0')",
+  "      --loopcache=INT           Size of the loop energy cache as log2(# of \n                                  entries), 0 disables the cache  \n                                  (default=`20')",
+  "  -m, --max=DOUBLE              Upper energy bound for sampling",
+  "  -f, --mod=DOUBLE              Final value of Wang-Landau modification factor",
+  "      --nfold                   Rejection-free (N-fold way) sampling: always \n                                  move, weighting each visit by its mean \n                                  residence time  (default=off)",
+  "  -n, --norm=INT                Number of bins used for normalization",
+  "      --normalize=STRING        Normalization of the scaled DOS: by the exact # \n                                  of structures in the lowest bin (bin), by the \n                                  exact total # of structures (count), or by a \n                                  least-squares fit to both (fit)  \n                                  (default=`bin')",
+  "      --outofrange=STRING       Policy for proposals above the sampling range \n                                  (grow|reject|abort)  (default=`grow')",
+  "      --pf-tolerance=DOUBLE     Stop when the ensemble free energy of the \n                                  scaled DOS is within this value (kcal/mol) of \n                                  the exact one from the partition function  \n                                  (default=`0')",
+  "      --pilotsteps=LONGLONG     Number of MC steps of the pilot run used by \n                                  --auto  (default=`1000000')",
+  "      --production=LONGLONG     Number of MC steps of a multicanonical \n                                  production run with fixed ln g after the last \n                                  stage, collecting per-bin averages of \n                                  structural observables  (default=`0')",
+  "      --reference-dos=STRING    Compare the scaled DOS estimate at every \n                                  crosscheck with this reference DOS (energy \n                                  and # of structures per line)",
+  "      --refine=INT              Number of coarse-to-fine refinement levels (bin \n                                  widths are halved on each level)  \n                                  (default=`0')",
+  "      --refinemod=DOUBLE        Value of Wang-Landau modification factor at \n                                  which a coarse level is refined  \n                                  (default=`0.001')",
+  "      --reservoir=INT           Keep a uniform random sample of this many \n                                  visited structures per bin (finest level), \n                                  written at the end of the run  (default=`0')",
+  "  -r, --resolution=DOUBLE       Sampling resolution (histogram bin width)  \n                                  (default=`0.5')",
+  "      --shared-dos=STRING       Share the DOS estimate with other RNAwl \n                                  processes through this (memory-mapped) file",
+  "      --sres=DOUBLE             Entropy resolution of --hs (cal/(mol K))  \n                                  (default=`3.0')",
+  "      --statecache=INT          Size of the cache of structure energies as \n                                  log2(# of entries), 0 disables the cache  \n                                  (default=`20')",
+  "  -l, --steplimit=LONGLONG      Maximum number of MC steps to perform  \n                                  (default=`100000000')",
+  "      --samc                    Stochastic approximation MC: update ln g with \n                                  the gain gamma0*t0/max(t0,t) instead of \n                                  flatness-driven reduction of f  (default=off)",
+  "  -S, --seed=LONG               Seed for random number generation",
+  "      --target-error=DOUBLE     Stop as soon as the mean relative error w.r.t. \n                                  --reference-dos is at most this value",
+  "      --tmmc                    Collect bin-to-bin transition counts and output \n                                  a TMMC estimate of the DOS  (default=off)",
+  "      --tmmcbias                Continue from the TMMC estimate whenever the \n                                  histogram is flat (implies --tmmc)  \n                                  (default=off)",
+  "      --thermo=STRING           Temperature grid (Celsius) as T or \n                                  from:to:step; ln Z, F, U, S and C(T) of the \n                                  DOS estimate are written at every crosscheck",
+  "      --t0=LONGLONG             Number of SAMC steps with constant gain  \n                                  (default=`100000')",
+  "  -T, --Temp=FLOAT              Simulation temperature in Celsius (currently \n                                  n/a)",
+  "      --tolerance=DOUBLE        Stop when no bin of the scaled ln g has changed \n                                  by more than this value at two successive \n                                  crosschecks (and, with --tmmc, ln g agrees as \n                                  closely with the TMMC estimate); 0 disables \n                                  this criterion  (default=`0')",
+  "  -t, --truedosbins=INT         Number of bins at the lower range of the energy\n                                  spectrum that get overwritten by effective \n                                  true DOS values (as computed by\n                                  RNAsubopt)",
+  "  -w, --walkers=INT             Number of walkers sharing the DOS estimate, \n                                  advanced in turns by one thread  \n                                  (default=`1')",
+  "      --verify                  Check every energy change against a full \n                                  evaluation of the structure  (default=off)",
+  "  -v, --verbose                 Verbose output  (default=off)",
+  "  -d, --debug                   Debugging output  (default=off)",
     0
 };
 
 typedef enum {ARG_NO
   , ARG_FLAG
+  , ARG_STRING
   , ARG_INT
   , ARG_LONG
   , ARG_FLOAT
@@ -81,20 +116,54 @@ void clear_given (struct gengetopt_args_info *args_info)
 {
   args_info->help_given = 0 ;
   args_info->version_given = 0 ;
+  args_info->auto_given = 0 ;
   args_info->bins_given = 0 ;
+  args_info->binedges_given = 0 ;
   args_info->checksteps_given = 0 ;
+  args_info->distance_given = 0 ;
   args_info->elow_given = 0 ;
   args_info->ehigh_given = 0 ;
+  args_info->count_tolerance_given = 0 ;
+  args_info->exact_given = 0 ;
   args_info->flat_given = 0 ;
+  args_info->gamma0_given = 0 ;
+  args_info->hll_given = 0 ;
+  args_info->hres_given = 0 ;
+  args_info->hs_given = 0 ;
   args_info->info_given = 0 ;
+  args_info->init_dos_given = 0 ;
+  args_info->init_mod_given = 0 ;
+  args_info->loopcache_given = 0 ;
   args_info->max_given = 0 ;
   args_info->mod_given = 0 ;
+  args_info->nfold_given = 0 ;
   args_info->norm_given = 0 ;
+  args_info->normalize_given = 0 ;
+  args_info->outofrange_given = 0 ;
+  args_info->pf_tolerance_given = 0 ;
+  args_info->pilotsteps_given = 0 ;
+  args_info->production_given = 0 ;
+  args_info->reference_dos_given = 0 ;
+  args_info->refine_given = 0 ;
+  args_info->refinemod_given = 0 ;
+  args_info->reservoir_given = 0 ;
   args_info->resolution_given = 0 ;
+  args_info->shared_dos_given = 0 ;
+  args_info->sres_given = 0 ;
+  args_info->statecache_given = 0 ;
   args_info->steplimit_given = 0 ;
+  args_info->samc_given = 0 ;
   args_info->seed_given = 0 ;
+  args_info->target_error_given = 0 ;
+  args_info->tmmc_given = 0 ;
+  args_info->tmmcbias_given = 0 ;
+  args_info->thermo_given = 0 ;
+  args_info->t0_given = 0 ;
   args_info->Temp_given = 0 ;
+  args_info->tolerance_given = 0 ;
   args_info->truedosbins_given = 0 ;
+  args_info->walkers_given = 0 ;
+  args_info->verify_given = 0 ;
   args_info->verbose_given = 0 ;
   args_info->debug_given = 0 ;
 }
@@ -103,25 +172,84 @@ static
 void clear_args (struct gengetopt_args_info *args_info)
 {
   FIX_UNUSED (args_info);
+  args_info->auto_flag = 0;
   args_info->bins_arg = 100;
   args_info->bins_orig = NULL;
+  args_info->binedges_arg = NULL;
+  args_info->binedges_orig = NULL;
   args_info->checksteps_arg = 1000000;
   args_info->checksteps_orig = NULL;
+  args_info->distance_arg = NULL;
+  args_info->distance_orig = NULL;
   args_info->elow_orig = NULL;
   args_info->ehigh_orig = NULL;
+  args_info->count_tolerance_arg = 0;
+  args_info->count_tolerance_orig = NULL;
+  args_info->exact_flag = 0;
   args_info->flat_arg = 0.8;
   args_info->flat_orig = NULL;
+  args_info->gamma0_arg = 1.0;
+  args_info->gamma0_orig = NULL;
+  args_info->hll_arg = 0;
+  args_info->hll_orig = NULL;
+  args_info->hres_arg = 1.0;
+  args_info->hres_orig = NULL;
+  args_info->hs_flag = 0;
   args_info->info_flag = 0;
+  args_info->init_dos_arg = NULL;
+  args_info->init_dos_orig = NULL;
+  args_info->init_mod_arg = 1.0;
+  args_info->init_mod_orig = NULL;
+  args_info->loopcache_arg = 20;
+  args_info->loopcache_orig = NULL;
   args_info->max_orig = NULL;
   args_info->mod_orig = NULL;
+  args_info->nfold_flag = 0;
   args_info->norm_orig = NULL;
+  args_info->normalize_arg = gengetopt_strdup ("bin");
+  args_info->normalize_orig = NULL;
+  args_info->outofrange_arg = gengetopt_strdup ("grow");
+  args_info->outofrange_orig = NULL;
+  args_info->pf_tolerance_arg = 0;
+  args_info->pf_tolerance_orig = NULL;
+  args_info->pilotsteps_arg = 1000000;
+  args_info->pilotsteps_orig = NULL;
+  args_info->production_arg = 0;
+  args_info->production_orig = NULL;
+  args_info->reference_dos_arg = NULL;
+  args_info->reference_dos_orig = NULL;
+  args_info->refine_arg = 0;
+  args_info->refine_orig = NULL;
+  args_info->refinemod_arg = 0.001;
+  args_info->refinemod_orig = NULL;
+  args_info->reservoir_arg = 0;
+  args_info->reservoir_orig = NULL;
   args_info->resolution_arg = 0.5;
   args_info->resolution_orig = NULL;
+  args_info->shared_dos_arg = NULL;
+  args_info->shared_dos_orig = NULL;
+  args_info->sres_arg = 3.0;
+  args_info->sres_orig = NULL;
+  args_info->statecache_arg = 20;
+  args_info->statecache_orig = NULL;
   args_info->steplimit_arg = 100000000;
   args_info->steplimit_orig = NULL;
+  args_info->samc_flag = 0;
   args_info->seed_orig = NULL;
+  args_info->target_error_orig = NULL;
+  args_info->tmmc_flag = 0;
+  args_info->tmmcbias_flag = 0;
+  args_info->thermo_arg = NULL;
+  args_info->thermo_orig = NULL;
+  args_info->t0_arg = 100000;
+  args_info->t0_orig = NULL;
   args_info->Temp_orig = NULL;
+  args_info->tolerance_arg = 0;
+  args_info->tolerance_orig = NULL;
   args_info->truedosbins_orig = NULL;
+  args_info->walkers_arg = 1;
+  args_info->walkers_orig = NULL;
+  args_info->verify_flag = 0;
   args_info->verbose_flag = 0;
   args_info->debug_flag = 0;
   
@@ -134,22 +262,56 @@ void init_args_info(struct gengetopt_args_info *args_info)
 
   args_info->help_help = gengetopt_args_info_help[0] ;
   args_info->version_help = gengetopt_args_info_help[1] ;
-  args_info->bins_help = gengetopt_args_info_help[3] ;
-  args_info->checksteps_help = gengetopt_args_info_help[4] ;
-  args_info->elow_help = gengetopt_args_info_help[5] ;
-  args_info->ehigh_help = gengetopt_args_info_help[6] ;
-  args_info->flat_help = gengetopt_args_info_help[7] ;
-  args_info->info_help = gengetopt_args_info_help[8] ;
-  args_info->max_help = gengetopt_args_info_help[9] ;
-  args_info->mod_help = gengetopt_args_info_help[10] ;
-  args_info->norm_help = gengetopt_args_info_help[11] ;
-  args_info->resolution_help = gengetopt_args_info_help[12] ;
-  args_info->steplimit_help = gengetopt_args_info_help[13] ;
-  args_info->seed_help = gengetopt_args_info_help[14] ;
-  args_info->Temp_help = gengetopt_args_info_help[15] ;
-  args_info->truedosbins_help = gengetopt_args_info_help[16] ;
-  args_info->verbose_help = gengetopt_args_info_help[17] ;
-  args_info->debug_help = gengetopt_args_info_help[18] ;
+  args_info->auto_help = gengetopt_args_info_help[3] ;
+  args_info->bins_help = gengetopt_args_info_help[4] ;
+  args_info->binedges_help = gengetopt_args_info_help[5] ;
+  args_info->checksteps_help = gengetopt_args_info_help[6] ;
+  args_info->distance_help = gengetopt_args_info_help[7] ;
+  args_info->elow_help = gengetopt_args_info_help[8] ;
+  args_info->ehigh_help = gengetopt_args_info_help[9] ;
+  args_info->count_tolerance_help = gengetopt_args_info_help[10] ;
+  args_info->exact_help = gengetopt_args_info_help[11] ;
+  args_info->flat_help = gengetopt_args_info_help[12] ;
+  args_info->gamma0_help = gengetopt_args_info_help[13] ;
+  args_info->hll_help = gengetopt_args_info_help[14] ;
+  args_info->hres_help = gengetopt_args_info_help[15] ;
+  args_info->hs_help = gengetopt_args_info_help[16] ;
+  args_info->info_help = gengetopt_args_info_help[17] ;
+  args_info->init_dos_help = gengetopt_args_info_help[18] ;
+  args_info->init_mod_help = gengetopt_args_info_help[19] ;
+  args_info->loopcache_help = gengetopt_args_info_help[20] ;
+  args_info->max_help = gengetopt_args_info_help[21] ;
+  args_info->mod_help = gengetopt_args_info_help[22] ;
+  args_info->nfold_help = gengetopt_args_info_help[23] ;
+  args_info->norm_help = gengetopt_args_info_help[24] ;
+  args_info->normalize_help = gengetopt_args_info_help[25] ;
+  args_info->outofrange_help = gengetopt_args_info_help[26] ;
+  args_info->pf_tolerance_help = gengetopt_args_info_help[27] ;
+  args_info->pilotsteps_help = gengetopt_args_info_help[28] ;
+  args_info->production_help = gengetopt_args_info_help[29] ;
+  args_info->reference_dos_help = gengetopt_args_info_help[30] ;
+  args_info->refine_help = gengetopt_args_info_help[31] ;
+  args_info->refinemod_help = gengetopt_args_info_help[32] ;
+  args_info->reservoir_help = gengetopt_args_info_help[33] ;
+  args_info->resolution_help = gengetopt_args_info_help[34] ;
+  args_info->shared_dos_help = gengetopt_args_info_help[35] ;
+  args_info->sres_help = gengetopt_args_info_help[36] ;
+  args_info->statecache_help = gengetopt_args_info_help[37] ;
+  args_info->steplimit_help = gengetopt_args_info_help[38] ;
+  args_info->samc_help = gengetopt_args_info_help[39] ;
+  args_info->seed_help = gengetopt_args_info_help[40] ;
+  args_info->target_error_help = gengetopt_args_info_help[41] ;
+  args_info->tmmc_help = gengetopt_args_info_help[42] ;
+  args_info->tmmcbias_help = gengetopt_args_info_help[43] ;
+  args_info->thermo_help = gengetopt_args_info_help[44] ;
+  args_info->t0_help = gengetopt_args_info_help[45] ;
+  args_info->Temp_help = gengetopt_args_info_help[46] ;
+  args_info->tolerance_help = gengetopt_args_info_help[47] ;
+  args_info->truedosbins_help = gengetopt_args_info_help[48] ;
+  args_info->walkers_help = gengetopt_args_info_help[49] ;
+  args_info->verify_help = gengetopt_args_info_help[50] ;
+  args_info->verbose_help = gengetopt_args_info_help[51] ;
+  args_info->debug_help = gengetopt_args_info_help[52] ;
   
 }
 
@@ -234,18 +396,52 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
 {
   unsigned int i;
   free_string_field (&(args_info->bins_orig));
+  free_string_field (&(args_info->binedges_arg));
+  free_string_field (&(args_info->binedges_orig));
   free_string_field (&(args_info->checksteps_orig));
+  free_string_field (&(args_info->distance_arg));
+  free_string_field (&(args_info->distance_orig));
   free_string_field (&(args_info->elow_orig));
   free_string_field (&(args_info->ehigh_orig));
+  free_string_field (&(args_info->count_tolerance_orig));
   free_string_field (&(args_info->flat_orig));
+  free_string_field (&(args_info->gamma0_orig));
+  free_string_field (&(args_info->hll_orig));
+  free_string_field (&(args_info->hres_orig));
+  free_string_field (&(args_info->init_dos_arg));
+  free_string_field (&(args_info->init_dos_orig));
+  free_string_field (&(args_info->init_mod_orig));
+  free_string_field (&(args_info->loopcache_orig));
   free_string_field (&(args_info->max_orig));
   free_string_field (&(args_info->mod_orig));
   free_string_field (&(args_info->norm_orig));
+  free_string_field (&(args_info->normalize_arg));
+  free_string_field (&(args_info->normalize_orig));
+  free_string_field (&(args_info->outofrange_arg));
+  free_string_field (&(args_info->outofrange_orig));
+  free_string_field (&(args_info->pf_tolerance_orig));
+  free_string_field (&(args_info->pilotsteps_orig));
+  free_string_field (&(args_info->production_orig));
+  free_string_field (&(args_info->reference_dos_arg));
+  free_string_field (&(args_info->reference_dos_orig));
+  free_string_field (&(args_info->refine_orig));
+  free_string_field (&(args_info->refinemod_orig));
+  free_string_field (&(args_info->reservoir_orig));
   free_string_field (&(args_info->resolution_orig));
+  free_string_field (&(args_info->shared_dos_arg));
+  free_string_field (&(args_info->shared_dos_orig));
+  free_string_field (&(args_info->sres_orig));
+  free_string_field (&(args_info->statecache_orig));
   free_string_field (&(args_info->steplimit_orig));
   free_string_field (&(args_info->seed_orig));
+  free_string_field (&(args_info->target_error_orig));
+  free_string_field (&(args_info->thermo_arg));
+  free_string_field (&(args_info->thermo_orig));
+  free_string_field (&(args_info->t0_orig));
   free_string_field (&(args_info->Temp_orig));
+  free_string_field (&(args_info->tolerance_orig));
   free_string_field (&(args_info->truedosbins_orig));
+  free_string_field (&(args_info->walkers_orig));
   
   
   for (i = 0; i < args_info->inputs_num; ++i)
@@ -285,34 +481,102 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "help", 0, 0 );
   if (args_info->version_given)
     write_into_file(outfile, "version", 0, 0 );
+  if (args_info->auto_given)
+    write_into_file(outfile, "auto", 0, 0 );
   if (args_info->bins_given)
     write_into_file(outfile, "bins", args_info->bins_orig, 0);
+  if (args_info->binedges_given)
+    write_into_file(outfile, "binedges", args_info->binedges_orig, 0);
   if (args_info->checksteps_given)
     write_into_file(outfile, "checksteps", args_info->checksteps_orig, 0);
+  if (args_info->distance_given)
+    write_into_file(outfile, "distance", args_info->distance_orig, 0);
   if (args_info->elow_given)
     write_into_file(outfile, "elow", args_info->elow_orig, 0);
   if (args_info->ehigh_given)
     write_into_file(outfile, "ehigh", args_info->ehigh_orig, 0);
+  if (args_info->count_tolerance_given)
+    write_into_file(outfile, "count-tolerance", args_info->count_tolerance_orig, 0);
+  if (args_info->exact_given)
+    write_into_file(outfile, "exact", 0, 0 );
   if (args_info->flat_given)
     write_into_file(outfile, "flat", args_info->flat_orig, 0);
+  if (args_info->gamma0_given)
+    write_into_file(outfile, "gamma0", args_info->gamma0_orig, 0);
+  if (args_info->hll_given)
+    write_into_file(outfile, "hll", args_info->hll_orig, 0);
+  if (args_info->hres_given)
+    write_into_file(outfile, "hres", args_info->hres_orig, 0);
+  if (args_info->hs_given)
+    write_into_file(outfile, "hs", 0, 0 );
   if (args_info->info_given)
     write_into_file(outfile, "info", 0, 0 );
+  if (args_info->init_dos_given)
+    write_into_file(outfile, "init-dos", args_info->init_dos_orig, 0);
+  if (args_info->init_mod_given)
+    write_into_file(outfile, "init-mod", args_info->init_mod_orig, 0);
+  if (args_info->loopcache_given)
+    write_into_file(outfile, "loopcache", args_info->loopcache_orig, 0);
   if (args_info->max_given)
     write_into_file(outfile, "max", args_info->max_orig, 0);
   if (args_info->mod_given)
     write_into_file(outfile, "mod", args_info->mod_orig, 0);
+  if (args_info->nfold_given)
+    write_into_file(outfile, "nfold", 0, 0 );
   if (args_info->norm_given)
     write_into_file(outfile, "norm", args_info->norm_orig, 0);
+  if (args_info->normalize_given)
+    write_into_file(outfile, "normalize", args_info->normalize_orig, 0);
+  if (args_info->outofrange_given)
+    write_into_file(outfile, "outofrange", args_info->outofrange_orig, 0);
+  if (args_info->pf_tolerance_given)
+    write_into_file(outfile, "pf-tolerance", args_info->pf_tolerance_orig, 0);
+  if (args_info->pilotsteps_given)
+    write_into_file(outfile, "pilotsteps", args_info->pilotsteps_orig, 0);
+  if (args_info->production_given)
+    write_into_file(outfile, "production", args_info->production_orig, 0);
+  if (args_info->reference_dos_given)
+    write_into_file(outfile, "reference-dos", args_info->reference_dos_orig, 0);
+  if (args_info->refine_given)
+    write_into_file(outfile, "refine", args_info->refine_orig, 0);
+  if (args_info->refinemod_given)
+    write_into_file(outfile, "refinemod", args_info->refinemod_orig, 0);
+  if (args_info->reservoir_given)
+    write_into_file(outfile, "reservoir", args_info->reservoir_orig, 0);
   if (args_info->resolution_given)
     write_into_file(outfile, "resolution", args_info->resolution_orig, 0);
+  if (args_info->shared_dos_given)
+    write_into_file(outfile, "shared-dos", args_info->shared_dos_orig, 0);
+  if (args_info->sres_given)
+    write_into_file(outfile, "sres", args_info->sres_orig, 0);
+  if (args_info->statecache_given)
+    write_into_file(outfile, "statecache", args_info->statecache_orig, 0);
   if (args_info->steplimit_given)
     write_into_file(outfile, "steplimit", args_info->steplimit_orig, 0);
+  if (args_info->samc_given)
+    write_into_file(outfile, "samc", 0, 0 );
   if (args_info->seed_given)
     write_into_file(outfile, "seed", args_info->seed_orig, 0);
+  if (args_info->target_error_given)
+    write_into_file(outfile, "target-error", args_info->target_error_orig, 0);
+  if (args_info->tmmc_given)
+    write_into_file(outfile, "tmmc", 0, 0 );
+  if (args_info->tmmcbias_given)
+    write_into_file(outfile, "tmmcbias", 0, 0 );
+  if (args_info->thermo_given)
+    write_into_file(outfile, "thermo", args_info->thermo_orig, 0);
+  if (args_info->t0_given)
+    write_into_file(outfile, "t0", args_info->t0_orig, 0);
   if (args_info->Temp_given)
     write_into_file(outfile, "Temp", args_info->Temp_orig, 0);
+  if (args_info->tolerance_given)
+    write_into_file(outfile, "tolerance", args_info->tolerance_orig, 0);
   if (args_info->truedosbins_given)
     write_into_file(outfile, "truedosbins", args_info->truedosbins_orig, 0);
+  if (args_info->walkers_given)
+    write_into_file(outfile, "walkers", args_info->walkers_orig, 0);
+  if (args_info->verify_given)
+    write_into_file(outfile, "verify", 0, 0 );
   if (args_info->verbose_given)
     write_into_file(outfile, "verbose", 0, 0 );
   if (args_info->debug_given)
@@ -452,6 +716,7 @@ int update_arg(void *field, char **orig_field,
   char *stop_char = 0;
   const char *val = value;
   int found;
+  char **string_field;
   FIX_UNUSED (field);
 
   stop_char = 0;
@@ -485,6 +750,14 @@ int update_arg(void *field, char **orig_field,
   case ARG_FLAG:
     *((int *)field) = !*((int *)field);
     break;
+  case ARG_STRING:
+    if (val) {
+      string_field = (char **)field;
+      if (!no_free && *string_field)
+        free (*string_field); /* free previous string */
+      *string_field = gengetopt_strdup (val);
+    }
+    break;
   case ARG_INT:
     if (val) *((int *)field) = strtol (val, &stop_char, 0);
     break;
@@ -584,26 +857,60 @@ cmdline_parser_internal (
       static struct option long_options[] = {
         { "help",	0, NULL, 'h' },
         { "version",	0, NULL, 'V' },
+        { "auto",	0, NULL, 'a' },
         { "bins",	1, NULL, 'b' },
+        { "binedges",	1, NULL, 0 },
         { "checksteps",	1, NULL, 'c' },
+        { "distance",	1, NULL, 0 },
         { "elow",	1, NULL, 0 },
         { "ehigh",	1, NULL, 0 },
+        { "count-tolerance",	1, NULL, 0 },
+        { "exact",	0, NULL, 0 },
         { "flat",	1, NULL, 0 },
+        { "gamma0",	1, NULL, 0 },
+        { "hll",	1, NULL, 0 },
+        { "hres",	1, NULL, 0 },
+        { "hs",	0, NULL, 0 },
         { "info",	0, NULL, 0 },
+        { "init-dos",	1, NULL, 0 },
+        { "init-mod",	1, NULL, 0 },
+        { "loopcache",	1, NULL, 0 },
         { "max",	1, NULL, 'm' },
         { "mod",	1, NULL, 'f' },
+        { "nfold",	0, NULL, 0 },
         { "norm",	1, NULL, 'n' },
+        { "normalize",	1, NULL, 0 },
+        { "outofrange",	1, NULL, 0 },
+        { "pf-tolerance",	1, NULL, 0 },
+        { "pilotsteps",	1, NULL, 0 },
+        { "production",	1, NULL, 0 },
+        { "reference-dos",	1, NULL, 0 },
+        { "refine",	1, NULL, 0 },
+        { "refinemod",	1, NULL, 0 },
+        { "reservoir",	1, NULL, 0 },
         { "resolution",	1, NULL, 'r' },
+        { "shared-dos",	1, NULL, 0 },
+        { "sres",	1, NULL, 0 },
+        { "statecache",	1, NULL, 0 },
         { "steplimit",	1, NULL, 'l' },
+        { "samc",	0, NULL, 0 },
         { "seed",	1, NULL, 'S' },
+        { "target-error",	1, NULL, 0 },
+        { "tmmc",	0, NULL, 0 },
+        { "tmmcbias",	0, NULL, 0 },
+        { "thermo",	1, NULL, 0 },
+        { "t0",	1, NULL, 0 },
         { "Temp",	1, NULL, 'T' },
+        { "tolerance",	1, NULL, 0 },
         { "truedosbins",	1, NULL, 't' },
+        { "walkers",	1, NULL, 'w' },
+        { "verify",	0, NULL, 0 },
         { "verbose",	0, NULL, 'v' },
         { "debug",	0, NULL, 'd' },
         { 0,  0, 0, 0 }
       };
 
-      c = getopt_long (argc, argv, "hVb:c:m:f:n:r:l:S:T:t:vd", long_options, &option_index);
+      c = getopt_long (argc, argv, "hVab:c:m:f:n:r:l:S:T:t:w:vd", long_options, &option_index);
 
       if (c == -1) break;	/* Exit from `while (1)' loop.  */
 
@@ -619,6 +926,16 @@ cmdline_parser_internal (
           cmdline_parser_free (&local_args_info);
           exit (EXIT_SUCCESS);
 
+        case 'a':	/* Determine sampling range and number of bins by a short pilot run.  */
+        
+        
+          if (update_arg((void *)&(args_info->auto_flag), 0, &(args_info->auto_given),
+              &(local_args_info.auto_given), optarg, 0, 0, ARG_FLAG,
+              check_ambiguity, override, 1, 0, "auto", 'a',
+              additional_error))
+            goto failure;
+        
+          break;
         case 'b':	/* Number of (equidistant) histogram bins.  */
         
         
@@ -740,6 +1057,18 @@ cmdline_parser_internal (
               additional_error))
             goto failure;
         
+          break;
+        case 'w':	/* Number of walkers sharing the DOS estimate, advanced in turns by one thread.  */
+        
+        
+          if (update_arg( (void *)&(args_info->walkers_arg), 
+               &(args_info->walkers_orig), &(args_info->walkers_given),
+              &(local_args_info.walkers_given), optarg, 0, "1", ARG_INT,
+              check_ambiguity, override, 0, 0,
+              "walkers", 'w',
+              additional_error))
+            goto failure;
+        
           break;
         case 'v':	/* Verbose output.  */
         
@@ -763,8 +1092,36 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
-          /* Lower limit of sampling window (currently n/a).  */
-          if (strcmp (long_options[option_index].name, "elow") == 0)
+          /* Read (non-uniform) histogram bin edges from file.  */
+          if (strcmp (long_options[option_index].name, "binedges") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->binedges_arg), 
+                 &(args_info->binedges_orig), &(args_info->binedges_given),
+                &(local_args_info.binedges_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "binedges", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Joint DOS over energy and base-pair distance to the start or mfe structure (start|mfe).  */
+          else if (strcmp (long_options[option_index].name, "distance") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->distance_arg), 
+                 &(args_info->distance_orig), &(args_info->distance_given),
+                &(local_args_info.distance_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "distance", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Lower limit of the sampling window; structures below it are never visited.  */
+          else if (strcmp (long_options[option_index].name, "elow") == 0)
           {
           
           
@@ -777,7 +1134,7 @@ cmdline_parser_internal (
               goto failure;
           
           }
-          /* Upper limit of sampling window (currently n/a).  */
+          /* Upper limit of the sampling window (like --max, but proposals above it are always rejected).  */
           else if (strcmp (long_options[option_index].name, "ehigh") == 0)
           {
           
@@ -790,6 +1147,32 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* Stop when ln of the total # of structures of the scaled DOS is within this value of the exact count.  */
+          else if (strcmp (long_options[option_index].name, "count-tolerance") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->count_tolerance_arg), 
+                 &(args_info->count_tolerance_orig), &(args_info->count_tolerance_given),
+                &(local_args_info.count_tolerance_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "count-tolerance", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Compute the exact DOS by dynamic programming (short sequences) and write it as .sDoS instead of sampling.  */
+          else if (strcmp (long_options[option_index].name, "exact") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->exact_flag), 0, &(args_info->exact_given),
+                &(local_args_info.exact_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "exact", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* Flatness criterion for the histogram.  */
           else if (strcmp (long_options[option_index].name, "flat") == 0)
@@ -804,6 +1187,60 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* Initial SAMC gain factor.  */
+          else if (strcmp (long_options[option_index].name, "gamma0") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->gamma0_arg), 
+                 &(args_info->gamma0_orig), &(args_info->gamma0_given),
+                &(local_args_info.gamma0_given), optarg, 0, "1.0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "gamma0", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Count distinct structures per bin with HyperLogLog sketches of 2^hll registers, 0 disables them.  */
+          else if (strcmp (long_options[option_index].name, "hll") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hll_arg), 
+                 &(args_info->hll_orig), &(args_info->hll_given),
+                &(local_args_info.hll_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "hll", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Enthalpy resolution of --hs (kcal/mol).  */
+          else if (strcmp (long_options[option_index].name, "hres") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->hres_arg), 
+                 &(args_info->hres_orig), &(args_info->hres_given),
+                &(local_args_info.hres_given), optarg, 0, "1.0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "hres", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Joint DOS over enthalpy and entropy, from which the thermodynamics at any temperature follow (see --thermo).  */
+          else if (strcmp (long_options[option_index].name, "hs") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->hs_flag), 0, &(args_info->hs_given),
+                &(local_args_info.hs_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "hs", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* Show settings.  */
           else if (strcmp (long_options[option_index].name, "info") == 0)
@@ -816,6 +1253,332 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* Initialize the DOS estimate from a previous .lDoS/.sDoS file.  */
+          else if (strcmp (long_options[option_index].name, "init-dos") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->init_dos_arg), 
+                 &(args_info->init_dos_orig), &(args_info->init_dos_given),
+                &(local_args_info.init_dos_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "init-dos", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Initial value of Wang-Landau modification factor.  */
+          else if (strcmp (long_options[option_index].name, "init-mod") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->init_mod_arg), 
+                 &(args_info->init_mod_orig), &(args_info->init_mod_given),
+                &(local_args_info.init_mod_given), optarg, 0, "1.0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "init-mod", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Size of the loop energy cache as log2(# of entries), 0 disables the cache.  */
+          else if (strcmp (long_options[option_index].name, "loopcache") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->loopcache_arg), 
+                 &(args_info->loopcache_orig), &(args_info->loopcache_given),
+                &(local_args_info.loopcache_given), optarg, 0, "20", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "loopcache", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Rejection-free (N-fold way) sampling: always move, weighting each visit by its mean residence time.  */
+          else if (strcmp (long_options[option_index].name, "nfold") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->nfold_flag), 0, &(args_info->nfold_given),
+                &(local_args_info.nfold_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "nfold", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Normalization of the scaled DOS: by the exact # of structures in the lowest bin (bin), by the exact total # of structures (count), or by a least-squares fit to both (fit).  */
+          else if (strcmp (long_options[option_index].name, "normalize") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->normalize_arg), 
+                 &(args_info->normalize_orig), &(args_info->normalize_given),
+                &(local_args_info.normalize_given), optarg, 0, "bin", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "normalize", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Policy for proposals above the sampling range (grow|reject|abort).  */
+          else if (strcmp (long_options[option_index].name, "outofrange") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->outofrange_arg), 
+                 &(args_info->outofrange_orig), &(args_info->outofrange_given),
+                &(local_args_info.outofrange_given), optarg, 0, "grow", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "outofrange", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Stop when the ensemble free energy of the scaled DOS is within this value (kcal/mol) of the exact one from the partition function.  */
+          else if (strcmp (long_options[option_index].name, "pf-tolerance") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->pf_tolerance_arg), 
+                 &(args_info->pf_tolerance_orig), &(args_info->pf_tolerance_given),
+                &(local_args_info.pf_tolerance_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "pf-tolerance", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of MC steps of the pilot run used by --auto.  */
+          else if (strcmp (long_options[option_index].name, "pilotsteps") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->pilotsteps_arg), 
+                 &(args_info->pilotsteps_orig), &(args_info->pilotsteps_given),
+                &(local_args_info.pilotsteps_given), optarg, 0, "1000000", ARG_LONGLONG,
+                check_ambiguity, override, 0, 0,
+                "pilotsteps", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of MC steps of a multicanonical production run with fixed ln g after the last stage, collecting per-bin averages of structural observables.  */
+          else if (strcmp (long_options[option_index].name, "production") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->production_arg), 
+                 &(args_info->production_orig), &(args_info->production_given),
+                &(local_args_info.production_given), optarg, 0, "0", ARG_LONGLONG,
+                check_ambiguity, override, 0, 0,
+                "production", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Compare the scaled DOS estimate at every crosscheck with this reference DOS (energy and # of structures per line).  */
+          else if (strcmp (long_options[option_index].name, "reference-dos") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->reference_dos_arg), 
+                 &(args_info->reference_dos_orig), &(args_info->reference_dos_given),
+                &(local_args_info.reference_dos_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "reference-dos", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of coarse-to-fine refinement levels (bin widths are halved on each level).  */
+          else if (strcmp (long_options[option_index].name, "refine") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->refine_arg), 
+                 &(args_info->refine_orig), &(args_info->refine_given),
+                &(local_args_info.refine_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "refine", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Value of Wang-Landau modification factor at which a coarse level is refined.  */
+          else if (strcmp (long_options[option_index].name, "refinemod") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->refinemod_arg), 
+                 &(args_info->refinemod_orig), &(args_info->refinemod_given),
+                &(local_args_info.refinemod_given), optarg, 0, "0.001", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "refinemod", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Keep a uniform random sample of this many visited structures per bin (finest level), written at the end of the run.  */
+          else if (strcmp (long_options[option_index].name, "reservoir") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->reservoir_arg), 
+                 &(args_info->reservoir_orig), &(args_info->reservoir_given),
+                &(local_args_info.reservoir_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "reservoir", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Share the DOS estimate with other RNAwl processes through this (memory-mapped) file.  */
+          else if (strcmp (long_options[option_index].name, "shared-dos") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->shared_dos_arg), 
+                 &(args_info->shared_dos_orig), &(args_info->shared_dos_given),
+                &(local_args_info.shared_dos_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "shared-dos", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Entropy resolution of --hs (cal/(mol K)).  */
+          else if (strcmp (long_options[option_index].name, "sres") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->sres_arg), 
+                 &(args_info->sres_orig), &(args_info->sres_given),
+                &(local_args_info.sres_given), optarg, 0, "3.0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "sres", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Size of the cache of structure energies as log2(# of entries), 0 disables the cache.  */
+          else if (strcmp (long_options[option_index].name, "statecache") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->statecache_arg), 
+                 &(args_info->statecache_orig), &(args_info->statecache_given),
+                &(local_args_info.statecache_given), optarg, 0, "20", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "statecache", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Stochastic approximation MC: update ln g with the gain gamma0*t0/max(t0,t) instead of flatness-driven reduction of f.  */
+          else if (strcmp (long_options[option_index].name, "samc") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->samc_flag), 0, &(args_info->samc_given),
+                &(local_args_info.samc_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "samc", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Stop as soon as the mean relative error w.r.t. --reference-dos is at most this value.  */
+          else if (strcmp (long_options[option_index].name, "target-error") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->target_error_arg), 
+                 &(args_info->target_error_orig), &(args_info->target_error_given),
+                &(local_args_info.target_error_given), optarg, 0, 0, ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "target-error", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Collect bin-to-bin transition counts and output a TMMC estimate of the DOS.  */
+          else if (strcmp (long_options[option_index].name, "tmmc") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->tmmc_flag), 0, &(args_info->tmmc_given),
+                &(local_args_info.tmmc_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "tmmc", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Continue from the TMMC estimate whenever the histogram is flat (implies --tmmc).  */
+          else if (strcmp (long_options[option_index].name, "tmmcbias") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->tmmcbias_flag), 0, &(args_info->tmmcbias_given),
+                &(local_args_info.tmmcbias_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "tmmcbias", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Temperature grid (Celsius) as T or from:to:step; ln Z, F, U, S and C(T) of the DOS estimate are written at every crosscheck.  */
+          else if (strcmp (long_options[option_index].name, "thermo") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->thermo_arg), 
+                 &(args_info->thermo_orig), &(args_info->thermo_given),
+                &(local_args_info.thermo_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "thermo", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of SAMC steps with constant gain.  */
+          else if (strcmp (long_options[option_index].name, "t0") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->t0_arg), 
+                 &(args_info->t0_orig), &(args_info->t0_given),
+                &(local_args_info.t0_given), optarg, 0, "100000", ARG_LONGLONG,
+                check_ambiguity, override, 0, 0,
+                "t0", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Stop when no bin of the scaled ln g has changed by more than this value at two successive crosschecks (and, with --tmmc, ln g agrees as closely with the TMMC estimate); 0 disables this criterion.  */
+          else if (strcmp (long_options[option_index].name, "tolerance") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->tolerance_arg), 
+                 &(args_info->tolerance_orig), &(args_info->tolerance_given),
+                &(local_args_info.tolerance_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "tolerance", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Check every energy change against a full evaluation of the structure.  */
+          else if (strcmp (long_options[option_index].name, "verify") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->verify_flag), 0, &(args_info->verify_given),
+                &(local_args_info.verify_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "verify", '-',
+                additional_error))
+              goto failure;
+          
           }
           
           break;
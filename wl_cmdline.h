@@ -43,9 +43,14 @@ struct gengetopt_args_info
 {
   const char *help_help; /**< @brief Print help and exit help description.  */
   const char *version_help; /**< @brief Print version and exit help description.  */
+  int auto_flag;	/**< @brief Determine sampling range and number of bins by a short pilot run (default=off).  */
+  const char *auto_help; /**< @brief Determine sampling range and number of bins by a short pilot run help description.  */
   int bins_arg;	/**< @brief Number of (equidistant) histogram bins (default='100').  */
   char * bins_orig;	/**< @brief Number of (equidistant) histogram bins original value given at command line.  */
   const char *bins_help; /**< @brief Number of (equidistant) histogram bins help description.  */
+  char * binedges_arg;	/**< @brief Read (non-uniform) histogram bin edges from file.  */
+  char * binedges_orig;	/**< @brief Read (non-uniform) histogram bin edges from file original value given at command line.  */
+  const char *binedges_help; /**< @brief Read (non-uniform) histogram bin edges from file help description.  */
   #ifdef HAVE_LONG_LONG
   long long int checksteps_arg;	/**< @brief Number of Wang-Landau steps before histogram is checked for flatness (default=1000000).  */
   #else
@@ -53,29 +58,103 @@ struct gengetopt_args_info
   #endif
   char * checksteps_orig;	/**< @brief Number of Wang-Landau steps before histogram is checked for flatness original value given at command line.  */
   const char *checksteps_help; /**< @brief Number of Wang-Landau steps before histogram is checked for flatness help description.  */
-  double elow_arg;	/**< @brief Lower limit of sampling window (currently n/a).  */
-  char * elow_orig;	/**< @brief Lower limit of sampling window (currently n/a) original value given at command line.  */
-  const char *elow_help; /**< @brief Lower limit of sampling window (currently n/a) help description.  */
-  double ehigh_arg;	/**< @brief Upper limit of sampling window (currently n/a).  */
-  char * ehigh_orig;	/**< @brief Upper limit of sampling window (currently n/a) original value given at command line.  */
-  const char *ehigh_help; /**< @brief Upper limit of sampling window (currently n/a) help description.  */
+  char * distance_arg;	/**< @brief Joint DOS over energy and base-pair distance to the start or mfe structure (start|mfe).  */
+  char * distance_orig;	/**< @brief Joint DOS over energy and base-pair distance to the start or mfe structure (start|mfe) original value given at command line.  */
+  const char *distance_help; /**< @brief Joint DOS over energy and base-pair distance to the start or mfe structure (start|mfe) help description.  */
+  double elow_arg;	/**< @brief Lower limit of the sampling window; structures below it are never visited.  */
+  char * elow_orig;	/**< @brief Lower limit of the sampling window; structures below it are never visited original value given at command line.  */
+  const char *elow_help; /**< @brief Lower limit of the sampling window; structures below it are never visited help description.  */
+  double ehigh_arg;	/**< @brief Upper limit of the sampling window (like --max, but proposals above it are always rejected).  */
+  char * ehigh_orig;	/**< @brief Upper limit of the sampling window (like --max, but proposals above it are always rejected) original value given at command line.  */
+  const char *ehigh_help; /**< @brief Upper limit of the sampling window (like --max, but proposals above it are always rejected) help description.  */
+  double count_tolerance_arg;	/**< @brief Stop when ln of the total # of structures of the scaled DOS is within this value of the exact count (default='0').  */
+  char * count_tolerance_orig;	/**< @brief Stop when ln of the total # of structures of the scaled DOS is within this value of the exact count original value given at command line.  */
+  const char *count_tolerance_help; /**< @brief Stop when ln of the total # of structures of the scaled DOS is within this value of the exact count help description.  */
+  int exact_flag;	/**< @brief Compute the exact DOS by dynamic programming (short sequences) and write it as .sDoS instead of sampling (default=off).  */
+  const char *exact_help; /**< @brief Compute the exact DOS by dynamic programming (short sequences) and write it as .sDoS instead of sampling help description.  */
   float flat_arg;	/**< @brief Flatness criterion for the histogram (default='0.8').  */
   char * flat_orig;	/**< @brief Flatness criterion for the histogram original value given at command line.  */
   const char *flat_help; /**< @brief Flatness criterion for the histogram help description.  */
+  double gamma0_arg;	/**< @brief Initial SAMC gain factor (default='1.0').  */
+  char * gamma0_orig;	/**< @brief Initial SAMC gain factor original value given at command line.  */
+  const char *gamma0_help; /**< @brief Initial SAMC gain factor help description.  */
+  int hll_arg;	/**< @brief Count distinct structures per bin with HyperLogLog sketches of 2^hll registers, 0 disables them (default='0').  */
+  char * hll_orig;	/**< @brief Count distinct structures per bin with HyperLogLog sketches of 2^hll registers, 0 disables them original value given at command line.  */
+  const char *hll_help; /**< @brief Count distinct structures per bin with HyperLogLog sketches of 2^hll registers, 0 disables them help description.  */
+  double hres_arg;	/**< @brief Enthalpy resolution of --hs (kcal/mol) (default='1.0').  */
+  char * hres_orig;	/**< @brief Enthalpy resolution of --hs (kcal/mol) original value given at command line.  */
+  const char *hres_help; /**< @brief Enthalpy resolution of --hs (kcal/mol) help description.  */
+  int hs_flag;	/**< @brief Joint DOS over enthalpy and entropy, from which the thermodynamics at any temperature follow (see --thermo) (default=off).  */
+  const char *hs_help; /**< @brief Joint DOS over enthalpy and entropy, from which the thermodynamics at any temperature follow (see --thermo) help description.  */
   int info_flag;	/**< @brief Show settings (default=off).  */
   const char *info_help; /**< @brief Show settings help description.  */
+  char * init_dos_arg;	/**< @brief Initialize the DOS estimate from a previous .lDoS/.sDoS file.  */
+  char * init_dos_orig;	/**< @brief Initialize the DOS estimate from a previous .lDoS/.sDoS file original value given at command line.  */
+  const char *init_dos_help; /**< @brief Initialize the DOS estimate from a previous .lDoS/.sDoS file help description.  */
+  double init_mod_arg;	/**< @brief Initial value of Wang-Landau modification factor (default='1.0').  */
+  char * init_mod_orig;	/**< @brief Initial value of Wang-Landau modification factor original value given at command line.  */
+  const char *init_mod_help; /**< @brief Initial value of Wang-Landau modification factor help description.  */
+  int loopcache_arg;	/**< @brief Size of the loop energy cache as log2(# of entries), 0 disables the cache (default='20').  */
+  char * loopcache_orig;	/**< @brief Size of the loop energy cache as log2(# of entries), 0 disables the cache original value given at command line.  */
+  const char *loopcache_help; /**< @brief Size of the loop energy cache as log2(# of entries), 0 disables the cache help description.  */
   double max_arg;	/**< @brief Upper energy bound for sampling.  */
   char * max_orig;	/**< @brief Upper energy bound for sampling original value given at command line.  */
   const char *max_help; /**< @brief Upper energy bound for sampling help description.  */
   double mod_arg;	/**< @brief Final value of Wang-Landau modification factor.  */
   char * mod_orig;	/**< @brief Final value of Wang-Landau modification factor original value given at command line.  */
   const char *mod_help; /**< @brief Final value of Wang-Landau modification factor help description.  */
+  int nfold_flag;	/**< @brief Rejection-free (N-fold way) sampling: always move, weighting each visit by its mean residence time (default=off).  */
+  const char *nfold_help; /**< @brief Rejection-free (N-fold way) sampling: always move, weighting each visit by its mean residence time help description.  */
   int norm_arg;	/**< @brief Number of bins used for normalization.  */
   char * norm_orig;	/**< @brief Number of bins used for normalization original value given at command line.  */
   const char *norm_help; /**< @brief Number of bins used for normalization help description.  */
+  char * normalize_arg;	/**< @brief Normalization of the scaled DOS: by the exact # of structures in the lowest bin (bin), by the exact total # of structures (count), or by a least-squares fit to both (fit) (default='bin').  */
+  char * normalize_orig;	/**< @brief Normalization of the scaled DOS: by the exact # of structures in the lowest bin (bin), by the exact total # of structures (count), or by a least-squares fit to both (fit) original value given at command line.  */
+  const char *normalize_help; /**< @brief Normalization of the scaled DOS: by the exact # of structures in the lowest bin (bin), by the exact total # of structures (count), or by a least-squares fit to both (fit) help description.  */
+  char * outofrange_arg;	/**< @brief Policy for proposals above the sampling range (grow|reject|abort) (default='grow').  */
+  char * outofrange_orig;	/**< @brief Policy for proposals above the sampling range (grow|reject|abort) original value given at command line.  */
+  const char *outofrange_help; /**< @brief Policy for proposals above the sampling range (grow|reject|abort) help description.  */
+  double pf_tolerance_arg;	/**< @brief Stop when the ensemble free energy of the scaled DOS is within this value (kcal/mol) of the exact one from the partition function (default='0').  */
+  char * pf_tolerance_orig;	/**< @brief Stop when the ensemble free energy of the scaled DOS is within this value (kcal/mol) of the exact one from the partition function original value given at command line.  */
+  const char *pf_tolerance_help; /**< @brief Stop when the ensemble free energy of the scaled DOS is within this value (kcal/mol) of the exact one from the partition function help description.  */
+  #ifdef HAVE_LONG_LONG
+  long long int pilotsteps_arg;	/**< @brief Number of MC steps of the pilot run used by --auto (default=1000000).  */
+  #else
+  long pilotsteps_arg;	/**< @brief Number of MC steps of the pilot run used by --auto (default=1000000).  */
+  #endif
+  char * pilotsteps_orig;	/**< @brief Number of MC steps of the pilot run used by --auto original value given at command line.  */
+  const char *pilotsteps_help; /**< @brief Number of MC steps of the pilot run used by --auto help description.  */
+  #ifdef HAVE_LONG_LONG
+  long long int production_arg;	/**< @brief Number of MC steps of a multicanonical production run with fixed ln g after the last stage, collecting per-bin averages of structural observables (default=0).  */
+  #else
+  long production_arg;	/**< @brief Number of MC steps of a multicanonical production run with fixed ln g after the last stage, collecting per-bin averages of structural observables (default=0).  */
+  #endif
+  char * production_orig;	/**< @brief Number of MC steps of a multicanonical production run with fixed ln g after the last stage, collecting per-bin averages of structural observables original value given at command line.  */
+  const char *production_help; /**< @brief Number of MC steps of a multicanonical production run with fixed ln g after the last stage, collecting per-bin averages of structural observables help description.  */
+  char * reference_dos_arg;	/**< @brief Compare the scaled DOS estimate at every crosscheck with this reference DOS (energy and # of structures per line).  */
+  char * reference_dos_orig;	/**< @brief Compare the scaled DOS estimate at every crosscheck with this reference DOS (energy and # of structures per line) original value given at command line.  */
+  const char *reference_dos_help; /**< @brief Compare the scaled DOS estimate at every crosscheck with this reference DOS (energy and # of structures per line) help description.  */
+  int refine_arg;	/**< @brief Number of coarse-to-fine refinement levels (bin widths are halved on each level) (default='0').  */
+  char * refine_orig;	/**< @brief Number of coarse-to-fine refinement levels (bin widths are halved on each level) original value given at command line.  */
+  const char *refine_help; /**< @brief Number of coarse-to-fine refinement levels (bin widths are halved on each level) help description.  */
+  double refinemod_arg;	/**< @brief Value of Wang-Landau modification factor at which a coarse level is refined (default='0.001').  */
+  char * refinemod_orig;	/**< @brief Value of Wang-Landau modification factor at which a coarse level is refined original value given at command line.  */
+  const char *refinemod_help; /**< @brief Value of Wang-Landau modification factor at which a coarse level is refined help description.  */
+  int reservoir_arg;	/**< @brief Keep a uniform random sample of this many visited structures per bin (finest level), written at the end of the run (default='0').  */
+  char * reservoir_orig;	/**< @brief Keep a uniform random sample of this many visited structures per bin (finest level), written at the end of the run original value given at command line.  */
+  const char *reservoir_help; /**< @brief Keep a uniform random sample of this many visited structures per bin (finest level), written at the end of the run help description.  */
   double resolution_arg;	/**< @brief Sampling resolution (histogram bin width) (default='0.5').  */
   char * resolution_orig;	/**< @brief Sampling resolution (histogram bin width) original value given at command line.  */
   const char *resolution_help; /**< @brief Sampling resolution (histogram bin width) help description.  */
+  char * shared_dos_arg;	/**< @brief Share the DOS estimate with other RNAwl processes through this (memory-mapped) file.  */
+  char * shared_dos_orig;	/**< @brief Share the DOS estimate with other RNAwl processes through this (memory-mapped) file original value given at command line.  */
+  const char *shared_dos_help; /**< @brief Share the DOS estimate with other RNAwl processes through this (memory-mapped) file help description.  */
+  double sres_arg;	/**< @brief Entropy resolution of --hs (cal/(mol K)) (default='3.0').  */
+  char * sres_orig;	/**< @brief Entropy resolution of --hs (cal/(mol K)) original value given at command line.  */
+  const char *sres_help; /**< @brief Entropy resolution of --hs (cal/(mol K)) help description.  */
+  int statecache_arg;	/**< @brief Size of the cache of structure energies as log2(# of entries), 0 disables the cache (default='20').  */
+  char * statecache_orig;	/**< @brief Size of the cache of structure energies as log2(# of entries), 0 disables the cache original value given at command line.  */
+  const char *statecache_help; /**< @brief Size of the cache of structure energies as log2(# of entries), 0 disables the cache help description.  */
   #ifdef HAVE_LONG_LONG
   long long int steplimit_arg;	/**< @brief Maximum number of MC steps to perform (default=100000000).  */
   #else
@@ -83,12 +162,34 @@ struct gengetopt_args_info
   #endif
   char * steplimit_orig;	/**< @brief Maximum number of MC steps to perform original value given at command line.  */
   const char *steplimit_help; /**< @brief Maximum number of MC steps to perform help description.  */
+  int samc_flag;	/**< @brief Stochastic approximation MC: update ln g with the gain gamma0*t0/max(t0,t) instead of flatness-driven reduction of f (default=off).  */
+  const char *samc_help; /**< @brief Stochastic approximation MC: update ln g with the gain gamma0*t0/max(t0,t) instead of flatness-driven reduction of f help description.  */
   long seed_arg;	/**< @brief Seed for random number generation.  */
   char * seed_orig;	/**< @brief Seed for random number generation original value given at command line.  */
   const char *seed_help; /**< @brief Seed for random number generation help description.  */
+  double target_error_arg;	/**< @brief Stop as soon as the mean relative error w.r.t. --reference-dos is at most this value.  */
+  char * target_error_orig;	/**< @brief Stop as soon as the mean relative error w.r.t. --reference-dos is at most this value original value given at command line.  */
+  const char *target_error_help; /**< @brief Stop as soon as the mean relative error w.r.t. --reference-dos is at most this value help description.  */
+  int tmmc_flag;	/**< @brief Collect bin-to-bin transition counts and output a TMMC estimate of the DOS (default=off).  */
+  const char *tmmc_help; /**< @brief Collect bin-to-bin transition counts and output a TMMC estimate of the DOS help description.  */
+  int tmmcbias_flag;	/**< @brief Continue from the TMMC estimate whenever the histogram is flat (implies --tmmc) (default=off).  */
+  const char *tmmcbias_help; /**< @brief Continue from the TMMC estimate whenever the histogram is flat (implies --tmmc) help description.  */
+  char * thermo_arg;	/**< @brief Temperature grid (Celsius) as T or from:to:step; ln Z, F, U, S and C(T) of the DOS estimate are written at every crosscheck.  */
+  char * thermo_orig;	/**< @brief Temperature grid (Celsius) as T or from:to:step; ln Z, F, U, S and C(T) of the DOS estimate are written at every crosscheck original value given at command line.  */
+  const char *thermo_help; /**< @brief Temperature grid (Celsius) as T or from:to:step; ln Z, F, U, S and C(T) of the DOS estimate are written at every crosscheck help description.  */
+  #ifdef HAVE_LONG_LONG
+  long long int t0_arg;	/**< @brief Number of SAMC steps with constant gain (default=100000).  */
+  #else
+  long t0_arg;	/**< @brief Number of SAMC steps with constant gain (default=100000).  */
+  #endif
+  char * t0_orig;	/**< @brief Number of SAMC steps with constant gain original value given at command line.  */
+  const char *t0_help; /**< @brief Number of SAMC steps with constant gain help description.  */
   float Temp_arg;	/**< @brief Simulation temperature in Celsius (currently n/a).  */
   char * Temp_orig;	/**< @brief Simulation temperature in Celsius (currently n/a) original value given at command line.  */
   const char *Temp_help; /**< @brief Simulation temperature in Celsius (currently n/a) help description.  */
+  double tolerance_arg;	/**< @brief Stop when no bin of the scaled ln g has changed by more than this value at two successive crosschecks (and, with --tmmc, ln g agrees as closely with the TMMC estimate); 0 disables this criterion (default='0').  */
+  char * tolerance_orig;	/**< @brief Stop when no bin of the scaled ln g has changed by more than this value at two successive crosschecks (and, with --tmmc, ln g agrees as closely with the TMMC estimate); 0 disables this criterion original value given at command line.  */
+  const char *tolerance_help; /**< @brief Stop when no bin of the scaled ln g has changed by more than this value at two successive crosschecks (and, with --tmmc, ln g agrees as closely with the TMMC estimate); 0 disables this criterion help description.  */
   int truedosbins_arg;	/**< @brief Number of bins at the lower range of the energy
   spectrum that get overwritten by effective true DOS values (as computed by
   RNAsubopt).  */
@@ -98,6 +199,11 @@ struct gengetopt_args_info
   const char *truedosbins_help; /**< @brief Number of bins at the lower range of the energy
   spectrum that get overwritten by effective true DOS values (as computed by
   RNAsubopt) help description.  */
+  int walkers_arg;	/**< @brief Number of walkers sharing the DOS estimate, advanced in turns by one thread (default='1').  */
+  char * walkers_orig;	/**< @brief Number of walkers sharing the DOS estimate, advanced in turns by one thread original value given at command line.  */
+  const char *walkers_help; /**< @brief Number of walkers sharing the DOS estimate, advanced in turns by one thread help description.  */
+  int verify_flag;	/**< @brief Check every energy change against a full evaluation of the structure (default=off).  */
+  const char *verify_help; /**< @brief Check every energy change against a full evaluation of the structure help description.  */
   int verbose_flag;	/**< @brief Verbose output (default=off).  */
   const char *verbose_help; /**< @brief Verbose output help description.  */
   int debug_flag;	/**< @brief Debugging output (default=off).  */
@@ -105,20 +211,54 @@ struct gengetopt_args_info
   
   unsigned int help_given ;	/**< @brief Whether help was given.  */
   unsigned int version_given ;	/**< @brief Whether version was given.  */
+  unsigned int auto_given ;	/**< @brief Whether auto was given.  */
   unsigned int bins_given ;	/**< @brief Whether bins was given.  */
+  unsigned int binedges_given ;	/**< @brief Whether binedges was given.  */
   unsigned int checksteps_given ;	/**< @brief Whether checksteps was given.  */
+  unsigned int distance_given ;	/**< @brief Whether distance was given.  */
   unsigned int elow_given ;	/**< @brief Whether elow was given.  */
   unsigned int ehigh_given ;	/**< @brief Whether ehigh was given.  */
+  unsigned int count_tolerance_given ;	/**< @brief Whether count-tolerance was given.  */
+  unsigned int exact_given ;	/**< @brief Whether exact was given.  */
   unsigned int flat_given ;	/**< @brief Whether flat was given.  */
+  unsigned int gamma0_given ;	/**< @brief Whether gamma0 was given.  */
+  unsigned int hll_given ;	/**< @brief Whether hll was given.  */
+  unsigned int hres_given ;	/**< @brief Whether hres was given.  */
+  unsigned int hs_given ;	/**< @brief Whether hs was given.  */
   unsigned int info_given ;	/**< @brief Whether info was given.  */
+  unsigned int init_dos_given ;	/**< @brief Whether init-dos was given.  */
+  unsigned int init_mod_given ;	/**< @brief Whether init-mod was given.  */
+  unsigned int loopcache_given ;	/**< @brief Whether loopcache was given.  */
   unsigned int max_given ;	/**< @brief Whether max was given.  */
   unsigned int mod_given ;	/**< @brief Whether mod was given.  */
+  unsigned int nfold_given ;	/**< @brief Whether nfold was given.  */
   unsigned int norm_given ;	/**< @brief Whether norm was given.  */
+  unsigned int normalize_given ;	/**< @brief Whether normalize was given.  */
+  unsigned int outofrange_given ;	/**< @brief Whether outofrange was given.  */
+  unsigned int pf_tolerance_given ;	/**< @brief Whether pf-tolerance was given.  */
+  unsigned int pilotsteps_given ;	/**< @brief Whether pilotsteps was given.  */
+  unsigned int production_given ;	/**< @brief Whether production was given.  */
+  unsigned int reference_dos_given ;	/**< @brief Whether reference-dos was given.  */
+  unsigned int refine_given ;	/**< @brief Whether refine was given.  */
+  unsigned int refinemod_given ;	/**< @brief Whether refinemod was given.  */
+  unsigned int reservoir_given ;	/**< @brief Whether reservoir was given.  */
   unsigned int resolution_given ;	/**< @brief Whether resolution was given.  */
+  unsigned int shared_dos_given ;	/**< @brief Whether shared-dos was given.  */
+  unsigned int sres_given ;	/**< @brief Whether sres was given.  */
+  unsigned int statecache_given ;	/**< @brief Whether statecache was given.  */
   unsigned int steplimit_given ;	/**< @brief Whether steplimit was given.  */
+  unsigned int samc_given ;	/**< @brief Whether samc was given.  */
   unsigned int seed_given ;	/**< @brief Whether seed was given.  */
+  unsigned int target_error_given ;	/**< @brief Whether target-error was given.  */
+  unsigned int tmmc_given ;	/**< @brief Whether tmmc was given.  */
+  unsigned int tmmcbias_given ;	/**< @brief Whether tmmcbias was given.  */
+  unsigned int thermo_given ;	/**< @brief Whether thermo was given.  */
+  unsigned int t0_given ;	/**< @brief Whether t0 was given.  */
   unsigned int Temp_given ;	/**< @brief Whether Temp was given.  */
+  unsigned int tolerance_given ;	/**< @brief Whether tolerance was given.  */
   unsigned int truedosbins_given ;	/**< @brief Whether truedosbins was given.  */
+  unsigned int walkers_given ;	/**< @brief Whether walkers was given.  */
+  unsigned int verify_given ;	/**< @brief Whether verify was given.  */
   unsigned int verbose_given ;	/**< @brief Whether verbose was given.  */
   unsigned int debug_given ;	/**< @brief Whether debug was given.  */
 
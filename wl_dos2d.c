@@ -0,0 +1,212 @@
+/*
+  wl_dos2d.c : sparse two-dimensional density of states
+  Last changed Time-stamp: <2026-10-19 20:14:51 mtw>
+*/
+
+/*
+  Only the cells a walk has entered are stored, in a hash table with
+  linear probing that is doubled whenever it becomes half full. Cells
+  are never deleted. Pointers to cells are valid up to the next
+  dos2d_insert().
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_dos2d.h"
+
+static void dos2d_grow(dos2d *);
+static int by_key(const void *, const void *);
+
+/* ==== */
+static inline size_t
+home_slot(const uint64_t key,
+	  const size_t mask)
+{
+  uint64_t x = key;
+
+  x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return (size_t)x & mask;
+}
+
+/* ==== */
+/* table with 2^bits slots initially */
+dos2d *
+dos2d_init(const int bits)
+{
+  dos2d *t = (dos2d*)calloc(1, sizeof(dos2d));
+  assert(t!=NULL);
+  t->mask = ((size_t)1 << bits) - 1;
+  t->slot = (dos2d_cell*)calloc(t->mask+1, sizeof(dos2d_cell));
+  assert(t->slot!=NULL);
+  return t;
+}
+
+/* ==== */
+/* cell (x,y), or NULL if it has not been entered yet */
+dos2d_cell *
+dos2d_find(const dos2d *t,
+	   const int x,
+	   const int y)
+{
+  const uint64_t key = (((uint64_t)x << 32) | (uint64_t)y) + 1;
+  size_t s;
+
+  for(s=home_slot(key,t->mask);t->slot[s].key != 0;s=(s+1)&t->mask){
+    if (t->slot[s].key == key){ return &t->slot[s]; }
+  }
+  return NULL;
+}
+
+/* ==== */
+/* cell (x,y); a new cell starts with ln g = g0 and no visits */
+dos2d_cell *
+dos2d_insert(dos2d *t,
+	     const int x,
+	     const int y,
+	     const double g0)
+{
+  const uint64_t key = (((uint64_t)x << 32) | (uint64_t)y) + 1;
+  size_t s;
+
+  if (2*(t->n+1) > t->mask+1){ dos2d_grow(t); }
+  for(s=home_slot(key,t->mask);t->slot[s].key != 0;s=(s+1)&t->mask){
+    if (t->slot[s].key == key){ return &t->slot[s]; }
+  }
+  t->slot[s].key = key;
+  t->slot[s].g = g0;
+  t->slot[s].h = 0.;
+  t->n++;
+  return &t->slot[s];
+}
+
+/* ==== */
+/* same criterion as for the one-dimensional histogram: every cell
+   visited in the current iteration has at least flat times the mean
+   # of visits */
+int
+dos2d_is_flat(const dos2d *t,
+	      const double flat)
+{
+  size_t s;
+  int b=0;
+  double sum=0.;
+
+  for(s=0;s<=t->mask;s++){
+    if (t->slot[s].key == 0 || t->slot[s].h == 0.){ continue; }
+    sum += t->slot[s].h;
+    b++;
+  }
+  if (b == 0){ return 0; }
+  for(s=0;s<=t->mask;s++){
+    if (t->slot[s].key == 0 || t->slot[s].h == 0.){ continue; }
+    if (t->slot[s].h < flat*sum/b){ return 0; }
+  }
+  return 1;
+}
+
+/* ==== */
+/* start a new iteration */
+void
+dos2d_reset(dos2d *t)
+{
+  size_t s;
+
+  for(s=0;s<=t->mask;s++){
+    t->slot[s].h = 0.;
+  }
+}
+
+/* ==== */
+/* marginal ln sum g over the cells that map to x, for x in [0,n); 0
+   where no cell does. Cell c maps to bin(c), or to its x if bin is
+   NULL; bin(c) < 0 leaves c out */
+void
+dos2d_project(const dos2d *t,
+	      double *lg,
+	      const size_t n,
+	      int (*bin)(const dos2d_cell *))
+{
+  size_t s;
+  int x;
+  double *m = (double*)malloc(n*sizeof(double));
+  int *b = (int*)malloc((t->mask+1)*sizeof(int));
+  assert(m!=NULL); assert(b!=NULL);
+
+  for(x=0;x<n;x++){
+    m[x] = -INFINITY;
+    lg[x] = 0.;
+  }
+  for(s=0;s<=t->mask;s++){
+    b[s] = -1;
+    if (t->slot[s].key == 0){ continue; }
+    x = (bin != NULL) ? bin(&t->slot[s]) : dos2d_x(&t->slot[s]);
+    if (x < 0 || x >= n){ continue; }
+    b[s] = x;
+    if (t->slot[s].g > m[x]){ m[x] = t->slot[s].g; }
+  }
+  for(s=0;s<=t->mask;s++){
+    if ((x = b[s]) >= 0){ lg[x] += exp(t->slot[s].g - m[x]); }
+  }
+  for(x=0;x<n;x++){
+    if (lg[x] > 0.){ lg[x] = m[x] + log(lg[x]); }
+  }
+  free(b);
+  free(m);
+}
+
+/* ==== */
+/* NULL-terminated list of the populated cells, ordered by x, then y */
+dos2d_cell **
+dos2d_sorted(const dos2d *t)
+{
+  size_t s,k=0;
+  dos2d_cell **c = (dos2d_cell**)calloc(t->n+1, sizeof(dos2d_cell*));
+  assert(c!=NULL);
+
+  for(s=0;s<=t->mask;s++){
+    if (t->slot[s].key != 0){ c[k++] = &t->slot[s]; }
+  }
+  qsort(c, k, sizeof(dos2d_cell*), by_key);
+  return c;
+}
+
+/* ==== */
+void
+dos2d_free(dos2d *t)
+{
+  if (t == NULL){ return; }
+  free(t->slot);
+  free(t);
+}
+
+/* ==== */
+static void
+dos2d_grow(dos2d *t)
+{
+  size_t s,k;
+  const size_t oldmask = t->mask;
+  dos2d_cell *old = t->slot;
+
+  t->mask = 2*oldmask+1;
+  t->slot = (dos2d_cell*)calloc(t->mask+1, sizeof(dos2d_cell));
+  assert(t->slot!=NULL);
+  for(s=0;s<=oldmask;s++){
+    if (old[s].key == 0){ continue; }
+    for(k=home_slot(old[s].key,t->mask);t->slot[k].key != 0;k=(k+1)&t->mask);
+    t->slot[k] = old[s];
+  }
+  free(old);
+}
+
+/* ==== */
+static int
+by_key(const void *a,
+       const void *b)
+{
+  const dos2d_cell *x = *(const dos2d_cell **)a, *y = *(const dos2d_cell **)b;
+
+  return (x->key > y->key) - (x->key < y->key);
+}
@@ -0,0 +1,49 @@
+/*  Last changed Time-stamp: <2026-10-19 20:14:51 mtw> */
+
+#ifndef WL_DOS2D_H
+#define WL_DOS2D_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* one populated cell (x,y) of a two-dimensional DOS; key 0 marks an
+   empty slot */
+typedef struct _dos2d_cell {
+  uint64_t key;     /* (x << 32 | y) + 1 */
+  double g;         /* ln g */
+  double h;         /* visits in the current iteration */
+} dos2d_cell;
+
+/* open-addressing table of the populated cells; x,y >= 0 */
+typedef struct _dos2d {
+  dos2d_cell *slot;
+  size_t mask;      /* # of slots - 1 */
+  size_t n;         /* # of populated cells */
+} dos2d;
+
+dos2d *dos2d_init(const int);
+dos2d_cell *dos2d_find(const dos2d *, const int, const int);
+dos2d_cell *dos2d_insert(dos2d *, const int, const int, const double);
+int dos2d_is_flat(const dos2d *, const double);
+void dos2d_reset(dos2d *);
+void dos2d_project(const dos2d *, double *, const size_t,
+		   int (*)(const dos2d_cell *));
+dos2d_cell **dos2d_sorted(const dos2d *);
+void dos2d_free(dos2d *);
+
+/* ==== */
+static inline int
+dos2d_x(const dos2d_cell *c)
+{
+  return (int)((c->key-1) >> 32);
+}
+
+/* ==== */
+static inline int
+dos2d_y(const dos2d_cell *c)
+{
+  return (int)((c->key-1) & 0xffffffffULL);
+}
+
+#endif
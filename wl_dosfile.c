@@ -0,0 +1,210 @@
+/*
+  wl_dosfile.c : reading (log) DOS files written by RNAwl and
+                 histogram bin edges
+  Last changed Time-stamp: <2026-10-19 10:12:41 mtw>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_dosfile.h"
+
+#define LINELEN 1024
+
+/* ==== */
+/* parse a two-column .lDoS/.sDoS file, skipping '#' comment lines */
+dosfile *
+read_dos_file(const char *fn)
+{
+  int i,size = 128;
+  double x,y;
+  char line[LINELEN];
+  FILE *fp=NULL;
+  dosfile *d=NULL;
+
+  if ((fp = fopen(fn, "r")) == NULL){
+    fprintf(stderr, "Cannot open DOS file %s\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  d = (dosfile*)calloc(1, sizeof(dosfile));
+  assert(d!=NULL);
+  d->e  = (double*)calloc(size, sizeof(double));
+  d->lg = (double*)calloc(size, sizeof(double));
+  assert(d->e!=NULL); assert(d->lg!=NULL);
+
+  while (fgets(line, LINELEN, fp) != NULL){
+    if (*line == '#' || *line == '\n'){ continue; }
+    if (sscanf(line, "%lf %lf", &x, &y) != 2){
+      fprintf(stderr, "error while parsing DOS file %s\n ---> %s <---\n",
+	      fn, line);
+      exit(EXIT_FAILURE);
+    }
+    if (d->n > 0 && x <= d->e[d->n-1]){
+      fprintf(stderr, "DOS file %s is not sorted by energy\n", fn);
+      exit(EXIT_FAILURE);
+    }
+    if (d->n == size){
+      size *= 2;
+      d->e  = (double*)realloc(d->e,  size*sizeof(double));
+      d->lg = (double*)realloc(d->lg, size*sizeof(double));
+      assert(d->e!=NULL); assert(d->lg!=NULL);
+    }
+    d->e[d->n]  = x;
+    d->lg[d->n] = y;
+    d->n++;
+  }
+  fclose(fp);
+
+  if (d->n == 0){
+    fprintf(stderr, "DOS file %s does not contain any data\n", fn);
+    exit(EXIT_FAILURE);
+  }
+
+  /* unpopulated bins are not written, hence the bin width of the
+     originating run is the smallest distance between two entries */
+  d->width = 0.;
+  for (i=0; i<d->n-1; i++){
+    y = d->e[i+1] - d->e[i];
+    if (d->width == 0. || y < d->width){ d->width = y; }
+  }
+  return d;
+}
+
+/* ==== */
+/* linear interpolation of ln g at energy en; values outside the
+   covered range are taken from the nearest entry */
+double
+interpolate_dos(const dosfile *d,
+		const double en)
+{
+  int lo=0,hi=d->n-1,mid;
+
+  if (en <= d->e[0])    { return d->lg[0]; }
+  if (en >= d->e[d->n-1]){ return d->lg[d->n-1]; }
+  while (hi - lo > 1){
+    mid = (lo+hi)/2;
+    if (d->e[mid] <= en){ lo = mid; }
+    else { hi = mid; }
+  }
+  return d->lg[lo] + (d->lg[hi]-d->lg[lo]) * (en-d->e[lo])/(d->e[hi]-d->e[lo]);
+}
+
+/* ==== */
+void
+free_dos_file(dosfile *d)
+{
+  if (d == NULL){ return; }
+  free(d->e);
+  free(d->lg);
+  free(d);
+}
+
+/* ==== */
+/* reference DOS, i.e. (exact) numbers of structures per energy as
+   written by RNAsubopt-based enumeration or RNAwl --exact; stored as
+   ln g */
+dosfile *
+read_reference_dos(const char *fn)
+{
+  int i;
+  dosfile *d = read_dos_file(fn);
+
+  for (i=0; i<d->n; i++){
+    if (d->lg[i] <= 0.){
+      fprintf(stderr, "reference DOS %s has a non-positive count at %6.2f\n",
+	      fn, d->e[i]);
+      exit(EXIT_FAILURE);
+    }
+    d->lg[i] = log(d->lg[i]);
+  }
+  return d;
+}
+
+/* ==== */
+/* relative error |ln g - ln g_ref|/|ln g_ref| of the n values lg at
+   energies e, compared to the reference entry at the same energy (as
+   written with two decimals); values without reference entry, with
+   ln g_ref = 0, or unvisited (ln g = 0, except the first one) are left
+   out. err[i] (if err != NULL) is set to the error of value i or -1.
+   Returns the # of values compared and sets their mean and max error */
+int
+dos_relative_error(const dosfile *ref,
+		   const double *e,
+		   const double *lg,
+		   const int n,
+		   double *err,
+		   double *mean,
+		   double *max)
+{
+  int i,lo,hi,mid,cnt=0;
+  double x,sum=0.;
+
+  *mean = *max = 0.;
+  for (i=0; i<n; i++){
+    if (err != NULL){ err[i] = -1.; }
+    if (i > 0 && lg[i] == 0.){ continue; }
+    lo = 0;
+    hi = ref->n-1;
+    while (lo < hi){ /* first entry >= e[i] minus rounding */
+      mid = (lo+hi)/2;
+      if (ref->e[mid] < e[i]-0.006){ lo = mid+1; }
+      else { hi = mid; }
+    }
+    if (fabs(ref->e[lo]-e[i]) > 0.006 || ref->lg[lo] == 0.){ continue; }
+    x = fabs((lg[i]-ref->lg[lo])/ref->lg[lo]);
+    if (err != NULL){ err[i] = x; }
+    sum += x;
+    if (x > *max){ *max = x; }
+    cnt++;
+  }
+  if (cnt > 0){ *mean = sum/cnt; }
+  return cnt;
+}
+
+/* ==== */
+/* read ascending histogram bin edges, one per line ('#' starts a
+   comment line); returns the edges and sets n to the number of bins */
+double *
+read_bin_edges(const char *fn,
+	       int *n)
+{
+  int k=0,size = 128;
+  double x,*edges=NULL;
+  char line[LINELEN];
+  FILE *fp=NULL;
+
+  if ((fp = fopen(fn, "r")) == NULL){
+    fprintf(stderr, "Cannot open bin edges file %s\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  edges = (double*)calloc(size, sizeof(double));
+  assert(edges!=NULL);
+  while (fgets(line, LINELEN, fp) != NULL){
+    if (*line == '#' || *line == '\n'){ continue; }
+    if (sscanf(line, "%lf", &x) != 1){
+      fprintf(stderr, "error while parsing bin edges file %s\n ---> %s <---\n",
+	      fn, line);
+      exit(EXIT_FAILURE);
+    }
+    if (k > 0 && x <= edges[k-1]){
+      fprintf(stderr, "bin edges in %s must be strictly ascending\n", fn);
+      exit(EXIT_FAILURE);
+    }
+    if (k == size){
+      size *= 2;
+      edges = (double*)realloc(edges, size*sizeof(double));
+      assert(edges!=NULL);
+    }
+    edges[k++] = x;
+  }
+  fclose(fp);
+
+  if (k < 2){
+    fprintf(stderr, "bin edges file %s must contain at least two edges\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  *n = k-1;
+  return edges;
+}
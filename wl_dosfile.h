@@ -0,0 +1,22 @@
+/*  Last changed Time-stamp: <2026-10-19 10:12:41 mtw> */
+
+#ifndef WL_DOSFILE_H
+#define WL_DOSFILE_H
+
+/* a DOS as read from disk: bin midpoints and (log) DOS values */
+typedef struct _dosfile {
+  int n;          /* # of data points */
+  double *e;      /* energies (bin midpoints), ascending */
+  double *lg;     /* ln g(E) */
+  double width;   /* bin width of the run that wrote the file */
+} dosfile;
+
+dosfile *read_dos_file(const char *);
+double interpolate_dos(const dosfile *, const double);
+void free_dos_file(dosfile *);
+dosfile *read_reference_dos(const char *);
+int dos_relative_error(const dosfile *, const double *, const double *,
+		       const int, double *, double *, double *);
+double *read_bin_edges(const char *, int *);
+
+#endif
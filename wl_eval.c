@@ -0,0 +1,61 @@
+/*
+  wl_eval.c : relative error of (many) sampled DOS files w.r.t. a
+              reference DOS, the native counterpart of
+              Perl/eval_sampledDOS.pl
+  Last changed Time-stamp: <2026-10-19 18:47:21 mtw>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "config.h"
+#include "wl_dosfile.h"
+#include "wl_eval_cmdline.h"
+
+static struct gengetopt_args_info args_info;
+
+/* ==== */
+int
+main(int argc, char **argv)
+{
+  int i,k,cnt;
+  double mean,max,*err=NULL;
+  dosfile *ref=NULL,*d=NULL;
+
+  if (cmdline_parser (argc, argv, &args_info) != 0){
+    fprintf(stderr, "error while parsing command-line options\n");
+    exit(EXIT_FAILURE);
+  }
+  if (!args_info.reference_given){
+    fprintf(stderr, "Please provide a reference DOS with -r\n");
+    exit(EXIT_FAILURE);
+  }
+  if (args_info.inputs_num < 1){
+    fprintf(stderr, "Please provide the sampled DOS files to evaluate\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /* the reference is read once for all files */
+  ref = read_reference_dos(args_info.reference_arg);
+  printf("# %-38s %6s %12s %12s\n","file","bins","mean","max");
+  for(k=0;k<args_info.inputs_num;k++){
+    d = read_dos_file(args_info.inputs[k]);
+    err = (double*)calloc(d->n, sizeof(double));
+    assert(err!=NULL);
+    cnt = dos_relative_error(ref,d->e,d->lg,d->n,err,&mean,&max);
+    if (args_info.perbin_given){
+      printf("# %s\n",args_info.inputs[k]);
+      for(i=0;i<d->n;i++){
+	if (err[i] < 0.){ continue; }
+	printf("%6.2f\t%g\n",d->e[i],err[i]);
+      }
+    }
+    printf("%-40s %6d %12.6g %12.6g\n",args_info.inputs[k],cnt,mean,max);
+    free(err);
+    free_dos_file(d);
+  }
+  free_dos_file(ref);
+  cmdline_parser_free(&args_info);
+  return (EXIT_SUCCESS);
+}
@@ -0,0 +1,462 @@
+/*
+  wl_exact.c : exact density of states by dynamic programming
+  Last changed Time-stamp: <2026-10-19 19:36:08 mtw>
+
+  The recursions are those of Zuker-type MFE folding (with dangles=2,
+  the ViennaRNA default), but every table entry holds the # of
+  structures per energy instead of the minimum energy, i.e. the min/+
+  algebra becomes +/convolution. Entries are sparse vectors over the
+  integer energies (dcal/mol) that actually occur. As in ViennaRNA,
+  interior loops have at most MAXLOOP unpaired bases, s.t. the fill is
+  O(n^3); structures with larger interior loops, which the move set can
+  form, are not counted. They only occur for sequences longer than
+  MAXLOOP+2*TURN+1 and lie far above the mfe.
+
+  C(i,j)  : structures on [i,j] closed by the pair (i,j)
+  M1(i,j) : multiloop segments with one stem (i,l), l <= j
+  M(i,j)  : multiloop segments with at least one stem
+  M2(i,j) : multiloop segments with at least two stems, shared by the
+            rules for C and M s.t. their convolutions are done once
+  F(j)    : exterior loop on [1,j]
+
+  Entries on one diagonal j-i are independent and filled in parallel
+  (OpenMP) if available.
+
+  Literature:
+  Cupal, J and Hofacker, IL and Stadler, PF (1996) Proc. GCB 96:
+  Dynamic programming algorithm for the density of states of RNA
+  secondary structures
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "wl_rna.h"
+#include "wl_exact.h"
+#include <ViennaRNA/hairpin_loops.h>
+#include <ViennaRNA/interior_loops.h>
+
+#define TURN 3              /* min # of unpaired bases in a hairpin */
+#ifndef MAXLOOP
+#define MAXLOOP 30          /* max # of unpaired bases in an interior loop */
+#endif
+#define FORBIDDEN 1000000   /* loop energies beyond are INF */
+
+/* dense accumulator for one table entry; filled in two passes, the
+   first of which only determines the energy range */
+typedef struct _accu {
+  int bounds;       /* first pass: only track lo and hi */
+  int lo;           /* lowest energy */
+  int hi;           /* highest energy */
+  size_t size;      /* allocated length of d */
+  double *d;        /* counts of energies lo..hi */
+} accu;
+
+/* tables and energy model */
+typedef struct _dptab {
+  int n;            /* sequence length */
+  short *S;         /* encoded sequence, 1-based */
+  vrna_param_t *P;  /* energy parameters */
+  vrna_md_t *md;    /* model details (pair types) */
+  vrna_fold_compound_t *vc;
+  dosvec *C,*M,*M1,*M2; /* (n+2)^2 entries each */
+} dptab;
+
+#define IDX(d,i,j) ((size_t)(i)*((d)->n+2)+(j))
+
+static void accu_start(accu *);
+static int accu_fill(accu *);
+static void accu_store(accu *, dosvec *);
+static void accu_unit(accu *, const int);
+static void accu_add(accu *, const dosvec *, const int);
+static void accu_conv(accu *, const dosvec *, const dosvec *, const int);
+static int ml_stem(const vrna_param_t *, const int, const int, const int);
+static int ext_stem(const vrna_param_t *, const int, const int, const int);
+static void rule_C(const dptab *, accu *, const int, const int);
+static void rule_M1(const dptab *, accu *, const int, const int);
+static void rule_M(const dptab *, accu *, const int, const int);
+static void rule_M2(const dptab *, accu *, const int, const int);
+static void fill(const dptab *, accu *, dosvec *,
+		 void (*)(const dptab *, accu *, const int, const int),
+		 const int, const int);
+
+/* ==== */
+/* # of structures per energy (dcal/mol) of seq at temperature T */
+dosvec *
+exact_dos(const char *seq,
+	  const float T)
+{
+  int i,j,k,l,type,e;
+  size_t z;
+  dptab d;
+  accu a = {0,0,0,0,NULL};
+  dosvec *F=NULL,*res=NULL;
+  vrna_md_t md;
+
+  vrna_md_set_default(&md);
+  md.temperature = T;
+  d.vc = vrna_fold_compound(seq,&md,VRNA_OPTION_MFE);
+  d.n  = strlen(seq);
+  d.S  = d.vc->sequence_encoding;
+  d.P  = d.vc->params;
+  d.md = &(d.P->model_details);
+  z = (size_t)(d.n+2)*(d.n+2);
+  d.C  = (dosvec*)calloc(z, sizeof(dosvec));
+  d.M  = (dosvec*)calloc(z, sizeof(dosvec));
+  d.M1 = (dosvec*)calloc(z, sizeof(dosvec));
+  d.M2 = (dosvec*)calloc(z, sizeof(dosvec));
+  assert(d.C!=NULL); assert(d.M!=NULL); assert(d.M1!=NULL); assert(d.M2!=NULL);
+
+  /* fill C, M1, M2 and M by increasing span */
+  for(l=TURN+1;l<d.n;l++){
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) private(j)
+#endif
+    for(i=1;i<=d.n-l;i++){
+      accu b = {0,0,0,0,NULL};
+      j = i+l;
+      fill(&d,&b,&d.C[IDX(&d,i,j)],rule_C,i,j);
+      fill(&d,&b,&d.M1[IDX(&d,i,j)],rule_M1,i,j);
+      fill(&d,&b,&d.M2[IDX(&d,i,j)],rule_M2,i,j);
+      fill(&d,&b,&d.M[IDX(&d,i,j)],rule_M,i,j);
+      free(b.d);
+    }
+  }
+
+  /* exterior loop: F(j) = F(j-1) + sum_k F(k-1) C(k,j) */
+  F = (dosvec*)calloc(d.n+1, sizeof(dosvec));
+  assert(F!=NULL);
+  for(j=0;j<=d.n;j++){
+    int pass;
+    accu_start(&a);
+    for(pass=0;pass<2;pass++){
+      if (pass == 1 && !accu_fill(&a)){ break; }
+      if (j == 0){
+	accu_unit(&a,0);
+	continue;
+      }
+      accu_add(&a,&F[j-1],0);
+      for(k=1;k<j-TURN;k++){
+	if ((type = d.md->pair[d.S[k]][d.S[j]]) == 0){ continue; }
+	e = ext_stem(d.P,type,(k>1) ? d.S[k-1] : -1,(j<d.n) ? d.S[j+1] : -1);
+	accu_conv(&a,&F[k-1],&d.C[IDX(&d,k,j)],e);
+      }
+    }
+    accu_store(&a,&F[j]);
+  }
+
+  res = (dosvec*)calloc(1, sizeof(dosvec));
+  assert(res!=NULL);
+  *res = F[d.n];
+  for(j=0;j<d.n;j++){
+    free(F[j].e);
+    free(F[j].c);
+  }
+  free(F);
+  for(z=0;z<(size_t)(d.n+2)*(d.n+2);z++){
+    free(d.C[z].e);  free(d.C[z].c);
+    free(d.M[z].e);  free(d.M[z].c);
+    free(d.M1[z].e); free(d.M1[z].c);
+    free(d.M2[z].e); free(d.M2[z].c);
+  }
+  free(d.C);
+  free(d.M);
+  free(d.M1);
+  free(d.M2);
+  free(a.d);
+  vrna_fold_compound_free(d.vc);
+  return res;
+}
+
+/* ==== */
+/* counts of v binned on the n bins with edges range[0..n], written as
+   a reference DOS (bin midpoint and # of structures per line; see
+   read_reference_dos()); counts outside the range are left out */
+void
+dosvec_fprintf(FILE *fp,
+	       const dosvec *v,
+	       const double *range,
+	       const int n)
+{
+  int i,k=0;
+  double c,en;
+
+  for(i=0;i<n;i++){
+    c = 0.;
+    for(;k<v->n;k++){
+      en = (double)v->e[k]/100;
+      if (en >= range[i+1]){ break; }
+      if (en >= range[i]){ c += v->c[k]; }
+    }
+    if (c == 0.){ continue; }
+    fprintf(fp,"%6.2f\t%.15g\n",(range[i]+range[i+1])/2,c);
+  }
+}
+
+/* ==== */
+void
+dosvec_free(dosvec *v)
+{
+  if (v == NULL){ return; }
+  free(v->e);
+  free(v->c);
+  free(v);
+}
+
+/* ==== */
+/* pair (i,j) closes a hairpin, an interior loop or a multiloop */
+static void
+rule_C(const dptab *d,
+       accu *a,
+       const int i,
+       const int j)
+{
+  int k,l,lmin,e;
+  const int type = d->md->pair[d->S[i]][d->S[j]];
+
+  if (type == 0){ return; }
+  if ((e = vrna_E_hp_loop(d->vc,i,j)) < FORBIDDEN){
+    accu_unit(a,e);
+  }
+  for(k=i+1;k<j-TURN-1 && k-i-1<=MAXLOOP;k++){
+    /* at most MAXLOOP-(k-i-1) unpaired bases between l and j */
+    lmin = j-1-(MAXLOOP-(k-i-1));
+    for(l=(lmin > k+TURN+1) ? lmin : k+TURN+1;l<j;l++){
+      const dosvec *v = &d->C[IDX(d,k,l)];
+      if (v->n == 0){ continue; }
+      if ((e = vrna_E_int_loop(d->vc,i,j,k,l)) < FORBIDDEN){
+	accu_add(a,v,e);
+      }
+    }
+  }
+  e = d->P->MLclosing +
+    ml_stem(d->P,d->md->rtype[type],d->S[j-1],d->S[i+1]);
+  accu_add(a,&d->M2[IDX(d,i+1,j-1)],e);
+}
+
+/* ==== */
+/* stem (i,l) followed by j-l unpaired bases; entries at the sequence
+   ends are never used inside a multiloop, but must not read S[0] (the
+   length) or S[n+1] */
+static void
+rule_M1(const dptab *d,
+	accu *a,
+	const int i,
+	const int j)
+{
+  int l,type;
+
+  for(l=i+TURN+1;l<=j;l++){
+    if ((type = d->md->pair[d->S[i]][d->S[l]]) == 0){ continue; }
+    accu_add(a,&d->C[IDX(d,i,l)],
+	     ml_stem(d->P,type,(i>1) ? d->S[i-1] : -1,(l<d->n) ? d->S[l+1] : -1) +
+	     d->P->MLbase*(j-l));
+  }
+}
+
+/* ==== */
+/* the last stem starts at k; before it are either unpaired bases or
+   further stems (M2) */
+static void
+rule_M(const dptab *d,
+       accu *a,
+       const int i,
+       const int j)
+{
+  int k;
+
+  for(k=i;k<j-TURN;k++){
+    accu_add(a,&d->M1[IDX(d,k,j)],d->P->MLbase*(k-i));
+  }
+  accu_add(a,&d->M2[IDX(d,i,j)],0);
+}
+
+/* ==== */
+/* the last stem starts at k, after at least one further stem */
+static void
+rule_M2(const dptab *d,
+	accu *a,
+	const int i,
+	const int j)
+{
+  int k;
+
+  for(k=i+TURN+2;k<j-TURN;k++){
+    accu_conv(a,&d->M[IDX(d,i,k-1)],&d->M1[IDX(d,k,j)],0);
+  }
+}
+
+/* ==== */
+/* energy of a multiloop stem of pair type type with 5' neighbor si and
+   3' neighbor sj (dangles=2) */
+static int
+ml_stem(const vrna_param_t *P,
+	const int type,
+	const int si,
+	const int sj)
+{
+  int e = P->MLintern[type];
+
+  if (si >= 0 && sj >= 0){ e += P->mismatchM[type][si][sj]; }
+  else if (si >= 0){ e += P->dangle5[type][si]; }
+  else if (sj >= 0){ e += P->dangle3[type][sj]; }
+  if (type > 2){ e += P->TerminalAU; }
+  return e;
+}
+
+/* ==== */
+/* the same for a stem in the exterior loop; -1 marks a missing
+   neighbor at the sequence ends */
+static int
+ext_stem(const vrna_param_t *P,
+	 const int type,
+	 const int si,
+	 const int sj)
+{
+  int e = 0;
+
+  if (si >= 0 && sj >= 0){ e += P->mismatchExt[type][si][sj]; }
+  else if (si >= 0){ e += P->dangle5[type][si]; }
+  else if (sj >= 0){ e += P->dangle3[type][sj]; }
+  if (type > 2){ e += P->TerminalAU; }
+  return e;
+}
+
+/* ==== */
+/* evaluate rule for entry (i,j) into v */
+static void
+fill(const dptab *d,
+     accu *a,
+     dosvec *v,
+     void (*rule)(const dptab *, accu *, const int, const int),
+     const int i,
+     const int j)
+{
+  accu_start(a);
+  rule(d,a,i,j);
+  if (accu_fill(a)){
+    rule(d,a,i,j);
+  }
+  accu_store(a,v);
+}
+
+/* ==== */
+static void
+accu_start(accu *a)
+{
+  a->bounds = 1;
+  a->lo = INT_MAX;
+  a->hi = INT_MIN;
+}
+
+/* ==== */
+/* switch to the second pass; returns 0 if there is nothing to add */
+static int
+accu_fill(accu *a)
+{
+  size_t len;
+
+  if (a->lo > a->hi){ return 0; }
+  len = (size_t)(a->hi - a->lo + 1);
+  if (len > a->size){
+    free(a->d);
+    a->d = (double*)malloc(len*sizeof(double));
+    assert(a->d!=NULL);
+    a->size = len;
+  }
+  memset(a->d, 0, len*sizeof(double));
+  a->bounds = 0;
+  return 1;
+}
+
+/* ==== */
+/* compress the accumulated counts into v */
+static void
+accu_store(accu *a,
+	   dosvec *v)
+{
+  int k,m=0;
+
+  v->n = 0;
+  v->e = NULL;
+  v->c = NULL;
+  if (a->bounds){ return; }  /* empty */
+  for(k=0;k<=a->hi-a->lo;k++){
+    if (a->d[k] != 0.){ m++; }
+  }
+  v->e = (int*)malloc(m*sizeof(int));
+  v->c = (double*)malloc(m*sizeof(double));
+  assert(v->e!=NULL); assert(v->c!=NULL);
+  for(k=0;k<=a->hi-a->lo;k++){
+    if (a->d[k] == 0.){ continue; }
+    v->e[v->n] = a->lo+k;
+    v->c[v->n] = a->d[k];
+    v->n++;
+  }
+}
+
+/* ==== */
+/* one structure of energy e */
+static void
+accu_unit(accu *a,
+	  const int e)
+{
+  if (a->bounds){
+    if (e < a->lo){ a->lo = e; }
+    if (e > a->hi){ a->hi = e; }
+    return;
+  }
+  a->d[e - a->lo] += 1.;
+}
+
+/* ==== */
+/* the structures of v, with energies shifted by shift */
+static void
+accu_add(accu *a,
+	 const dosvec *v,
+	 const int shift)
+{
+  int k;
+  double *d;
+
+  if (v->n == 0){ return; }
+  if (a->bounds){
+    if (v->e[0]+shift < a->lo){ a->lo = v->e[0]+shift; }
+    if (v->e[v->n-1]+shift > a->hi){ a->hi = v->e[v->n-1]+shift; }
+    return;
+  }
+  d = a->d + shift - a->lo;
+  for(k=0;k<v->n;k++){
+    d[v->e[k]] += v->c[k];
+  }
+}
+
+/* ==== */
+/* all combinations of the structures of v and w, with energies
+   shifted by shift */
+static void
+accu_conv(accu *a,
+	  const dosvec *v,
+	  const dosvec *w,
+	  const int shift)
+{
+  int k,m;
+  double *d;
+
+  if (v->n == 0 || w->n == 0){ return; }
+  if (a->bounds){
+    if (v->e[0]+w->e[0]+shift < a->lo){ a->lo = v->e[0]+w->e[0]+shift; }
+    if (v->e[v->n-1]+w->e[w->n-1]+shift > a->hi){
+      a->hi = v->e[v->n-1]+w->e[w->n-1]+shift;
+    }
+    return;
+  }
+  for(k=0;k<v->n;k++){
+    d = a->d + v->e[k] + shift - a->lo;
+    for(m=0;m<w->n;m++){
+      d[w->e[m]] += v->c[k]*w->c[m];
+    }
+  }
+}
@@ -0,0 +1,19 @@
+/*  Last changed Time-stamp: <2026-10-19 19:36:08 mtw> */
+
+#ifndef WL_EXACT_H
+#define WL_EXACT_H
+
+#include <stdio.h>
+
+/* sparse count vector: # of structures per energy */
+typedef struct _dosvec {
+  int n;            /* # of energies with structures */
+  int *e;           /* energies (dcal/mol), ascending */
+  double *c;        /* # of structures with energy e[k] */
+} dosvec;
+
+dosvec *exact_dos(const char *, const float);
+void dosvec_fprintf(FILE *, const dosvec *, const double *, const int);
+void dosvec_free(dosvec *);
+
+#endif
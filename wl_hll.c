@@ -0,0 +1,82 @@
+/*
+  wl_hll.c : per-bin HyperLogLog counts of distinct structures
+  Last changed Time-stamp: <2026-10-19 17:12:30 mtw>
+
+  Literature:
+  Flajolet, P and Fusy, E and Gandouet, O and Meunier, F (2007)
+  HyperLogLog: the analysis of a near-optimal cardinality estimation
+  algorithm. Proc. AofA 2007, DMTCS proc. AH 127-146
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_hll.h"
+
+/* ==== */
+/* n sketches with 2^p registers each */
+hll *
+hll_init(const int n,
+	 const int p)
+{
+  hll *s = (hll*)calloc(1, sizeof(hll));
+  assert(s!=NULL);
+  s->n = n;
+  s->p = p;
+  s->reg = (unsigned char*)calloc((size_t)n << p, sizeof(unsigned char));
+  assert(s->reg!=NULL);
+  return s;
+}
+
+/* ==== */
+/* add sketches for bins appended at the high end */
+void
+hll_resize(hll *s,
+	   const int n)
+{
+  if (n <= s->n){ return; }
+  s->reg = (unsigned char*)realloc(s->reg, (size_t)n << s->p);
+  assert(s->reg!=NULL);
+  memset(s->reg + ((size_t)s->n << s->p), 0, (size_t)(n - s->n) << s->p);
+  s->n = n;
+}
+
+/* ==== */
+/* estimated # of distinct structures in bin b */
+double
+hll_estimate(const hll *s,
+	     const int b)
+{
+  int k,zeros=0;
+  const int m = 1 << s->p;
+  const unsigned char *r = s->reg + ((size_t)b << s->p);
+  double sum=0.,est,alpha;
+
+  for(k=0;k<m;k++){
+    sum += ldexp(1.,-r[k]);
+    if (r[k] == 0){ zeros++; }
+  }
+  if (zeros == m){ return 0.; }
+  switch (m){
+  case 16: alpha = 0.673; break;
+  case 32: alpha = 0.697; break;
+  case 64: alpha = 0.709; break;
+  default: alpha = 0.7213/(1.+1.079/m);
+  }
+  est = alpha*m*m/sum;
+  if (est <= 2.5*m && zeros > 0){ /* small range: linear counting */
+    est = m*log((double)m/zeros);
+  }
+  return est;
+}
+
+/* ==== */
+void
+hll_free(hll *s)
+{
+  if (s == NULL){ return; }
+  free(s->reg);
+  free(s);
+}
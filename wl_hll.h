@@ -0,0 +1,32 @@
+/*  Last changed Time-stamp: <2026-10-19 17:12:30 mtw> */
+
+#ifndef WL_HLL_H
+#define WL_HLL_H
+
+#include <stdint.h>
+
+/* one HyperLogLog sketch of distinct structures per histogram bin */
+typedef struct _hll {
+  int n;            /* # of bins */
+  int p;            /* precision, i.e. 2^p registers per bin */
+  unsigned char *reg; /* registers, n * 2^p */
+} hll;
+
+hll *hll_init(const int, const int);
+void hll_resize(hll *, const int);
+double hll_estimate(const hll *, const int);
+void hll_free(hll *);
+
+/* ==== */
+/* add a structure with hash x to the sketch of bin b */
+static inline void
+hll_add(hll *s, const int b, const uint64_t x)
+{
+  const uint64_t w = x << s->p;
+  const unsigned char rank = (w == 0) ? 64 - s->p + 1 : __builtin_clzll(w) + 1;
+  unsigned char *r = s->reg + ((size_t)b << s->p) + (x >> (64 - s->p));
+
+  if (rank > *r){ *r = rank; }
+}
+
+#endif
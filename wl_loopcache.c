@@ -0,0 +1,102 @@
+/*
+  wl_loopcache.c : bounded hash table of loop energies
+  Last changed Time-stamp: <2026-10-20 00:12:40 mtw>
+*/
+
+/*
+  Linear probing over at most LOOPCACHE_PROBES consecutive slots; if
+  all of them are taken, the home slot is overwritten. Entries are
+  never deleted, so lookups stop at the first empty slot.
+
+  Key 0 marks an empty slot, but a hash may well be 0 (the Zobrist
+  hash of the open chain is), so keys are stored with bit 0 set.
+  Keys differing only in bit 0 share an entry.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "wl_loopcache.h"
+
+#define LOOPCACHE_PROBES 8
+#define STORED_KEY(K) ((K) | (uint64_t)1)
+
+/* ==== */
+/* table with 2^bits slots */
+loopcache *
+loopcache_init(const int bits)
+{
+  loopcache *c = (loopcache*)calloc(1, sizeof(loopcache));
+  assert(c!=NULL);
+  c->mask = ((size_t)1 << bits) - 1;
+  c->slot = (loopcache_entry*)calloc(c->mask+1, sizeof(loopcache_entry));
+  assert(c->slot!=NULL);
+  return c;
+}
+
+/* ==== */
+/* returns 1 and sets *e if key is in the table */
+int
+loopcache_get(loopcache *c,
+	      const uint64_t hash,
+	      int *e)
+{
+  int k;
+  size_t s;
+  const uint64_t key = STORED_KEY(hash);
+
+  c->lookups++;
+  for(k=0,s=key&c->mask;k<LOOPCACHE_PROBES;k++,s=(s+1)&c->mask){
+    if (c->slot[s].key == key){
+      *e = c->slot[s].energy;
+      c->hits++;
+      return 1;
+    }
+    if (c->slot[s].key == 0){ break; }
+  }
+  return 0;
+}
+
+/* ==== */
+void
+loopcache_put(loopcache *c,
+	      const uint64_t hash,
+	      const int e)
+{
+  int k;
+  size_t s;
+  const uint64_t key = STORED_KEY(hash);
+
+  for(k=0,s=key&c->mask;k<LOOPCACHE_PROBES;k++,s=(s+1)&c->mask){
+    if (c->slot[s].key == 0 || c->slot[s].key == key){
+      c->slot[s].key = key;
+      c->slot[s].energy = e;
+      return;
+    }
+  }
+  s = key&c->mask;
+  c->slot[s].key = key;
+  c->slot[s].energy = e;
+  c->evictions++;
+}
+
+/* ==== */
+void
+loopcache_report(FILE *fp,
+		 const char *name,
+		 const loopcache *c)
+{
+  fprintf(fp,"# %s cache: %lu lookups, %lu hits (%.2f%%), %lu evictions, %lu slots\n",
+	  name,c->lookups,c->hits,
+	  c->lookups ? 100.*c->hits/c->lookups : 0.,
+	  c->evictions,(unsigned long)(c->mask+1));
+}
+
+/* ==== */
+void
+loopcache_free(loopcache *c)
+{
+  if (c == NULL){ return; }
+  free(c->slot);
+  free(c);
+}
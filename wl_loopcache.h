@@ -0,0 +1,32 @@
+/*  Last changed Time-stamp: <2026-10-20 00:12:40 mtw> */
+
+#ifndef WL_LOOPCACHE_H
+#define WL_LOOPCACHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* one slot of the loop energy cache; key 0 marks an empty slot, stored
+   keys have bit 0 set */
+typedef struct _loopcache_entry {
+  uint64_t key;     /* hash of closing pair and enclosed pairs, | 1 */
+  int energy;       /* loop energy (dcal/mol) */
+} loopcache_entry;
+
+/* fixed-size open-addressing table of loop energies */
+typedef struct _loopcache {
+  loopcache_entry *slot;
+  size_t mask;              /* # of slots - 1 */
+  unsigned long lookups;    /* # of lookups */
+  unsigned long hits;       /* # of lookups answered from the cache */
+  unsigned long evictions;  /* # of entries overwritten */
+} loopcache;
+
+loopcache *loopcache_init(const int);
+int loopcache_get(loopcache *, const uint64_t, int *);
+void loopcache_put(loopcache *, const uint64_t, const int);
+void loopcache_report(FILE *, const char *, const loopcache *);
+void loopcache_free(loopcache *);
+
+#endif
@@ -0,0 +1,201 @@
+/*
+  wl_looptree.c : incremental energy evaluation of pair insertions and
+                  deletions on an explicit loop decomposition
+  Last changed Time-stamp: <2026-10-19 16:02:44 mtw>
+*/
+
+/*
+  Inserting pair (i,j) into loop p splits p into a smaller p and the
+  new loop closed by (i,j); deleting (i,j) merges the loop closed by
+  (i,j) into its enclosing loop p. Loop energies (dangles=2) only
+  depend on the loop itself, hence the energy change of a move follows
+  from the cached energies of at most two loops and the evaluation of
+  at most two new ones. The enclosing loop is looked up in parent[]
+  instead of scanning the pair table.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "wl_looptree.h"
+
+static int loop_energy(looptree *, vrna_fold_compound_t *, const int, const short *);
+static uint64_t loop_key(const short *, const int);
+
+/* ==== */
+looptree *
+looptree_init(vrna_fold_compound_t *vc,
+	      short *pt,
+	      loopcache *cache)
+{
+  int k,top=0;
+  looptree *lt = (looptree*)calloc(1, sizeof(looptree));
+  assert(lt!=NULL);
+
+  lt->n = pt[0];
+  lt->cache = cache;
+  lt->parent = (short*)calloc(lt->n+1, sizeof(short));
+  lt->stack  = (short*)calloc(lt->n+1, sizeof(short));
+  lt->energy = (int*)calloc(lt->n+1, sizeof(int));
+  assert(lt->parent!=NULL); assert(lt->stack!=NULL); assert(lt->energy!=NULL);
+
+  for(k=1;k<=lt->n;k++){
+    if (pt[k] != 0 && pt[k] < k){ top--; }  /* closing a pair */
+    lt->parent[k] = (top > 0) ? lt->stack[top-1] : 0;
+    if (pt[k] > k){                          /* opening a pair */
+      lt->stack[top++] = k;
+      lt->energy[k] = loop_energy(lt,vc,k,pt);
+    }
+  }
+  lt->energy[0] = loop_energy(lt,vc,0,pt);
+  lt->evals = 0;
+  lt->mi = lt->mj = 0;
+  return lt;
+}
+
+/* ==== */
+/* energy change of inserting (i,j) (i,j > 0) or deleting (-i,-j)
+   (i,j < 0); pt is modified temporarily */
+int
+looptree_eval_move(looptree *lt,
+		   vrna_fold_compound_t *vc,
+		   short *pt,
+		   const int i,
+		   const int j)
+{
+  int p,de;
+
+  lt->mi = i;
+  lt->mj = j;
+  if (i > 0){ /* insertion */
+    p = lt->parent[i];
+    pt[i] = j; pt[j] = i;
+    lt->ep = loop_energy(lt,vc,p,pt);
+    lt->ei = loop_energy(lt,vc,i,pt);
+    pt[i] = pt[j] = 0;
+    de = lt->ep + lt->ei - lt->energy[p];
+  }
+  else {      /* deletion */
+    p = lt->parent[-i];
+    pt[-i] = pt[-j] = 0;
+    lt->ep = loop_energy(lt,vc,p,pt);
+    lt->ei = 0;
+    pt[-i] = -j; pt[-j] = -i;
+    de = lt->ep - lt->energy[p] - lt->energy[-i];
+  }
+  return de;
+}
+
+/* ==== */
+/* update the loop decomposition after move (i,j) has been applied to
+   pt */
+void
+looptree_apply_move(looptree *lt,
+		    vrna_fold_compound_t *vc,
+		    short *pt,
+		    const int i,
+		    const int j)
+{
+  int k,p,a = abs(i),b = abs(j);
+
+  if (lt->mi != i || lt->mj != j){ /* not the move evaluated last */
+    if (i > 0){
+      pt[i] = pt[j] = 0;
+    }
+    else {
+      pt[a] = b; pt[b] = a;
+    }
+    looptree_eval_move(lt,vc,pt,i,j);
+    if (i > 0){
+      pt[i] = j; pt[j] = i;
+    }
+    else {
+      pt[a] = pt[b] = 0;
+    }
+  }
+
+  p = lt->parent[a];
+  lt->energy[p] = lt->ep;
+  lt->energy[a] = lt->ei;
+  /* positions of the loop closed by (a,b) change their loop; pairs
+     inside it are skipped over */
+  for(k=a+1;k<b;k++){
+    lt->parent[k] = (i > 0) ? a : p;
+    if (pt[k] > k){
+      k = pt[k];
+      lt->parent[k] = (i > 0) ? a : p;
+    }
+  }
+  lt->mi = lt->mj = 0;
+}
+
+/* ==== */
+/* total energy as sum over all loops; entries of positions that do
+   not close a pair are 0 */
+int
+looptree_energy(const looptree *lt)
+{
+  int k,e=0;
+
+  for(k=0;k<=lt->n;k++){ e += lt->energy[k]; }
+  return e;
+}
+
+/* ==== */
+void
+looptree_free(looptree *lt)
+{
+  if (lt == NULL){ return; }
+  free(lt->parent);
+  free(lt->energy);
+  free(lt->stack);
+  free(lt);
+}
+
+/* ==== */
+/* energy of the loop closed by the pair at i (0: exterior loop),
+   looked up in the cache first */
+static int
+loop_energy(looptree *lt,
+	    vrna_fold_compound_t *vc,
+	    const int i,
+	    const short *pt)
+{
+  int e;
+  uint64_t key;
+
+  lt->evals++;
+  if (lt->cache == NULL){
+    return vrna_eval_loop_pt(vc,i,pt);
+  }
+  key = loop_key(pt,i);
+  if (!loopcache_get(lt->cache,key,&e)){
+    e = vrna_eval_loop_pt(vc,i,pt);
+    loopcache_put(lt->cache,key,e);
+  }
+  return e;
+}
+
+/* ==== */
+/* hash of the closing pair and the pairs enclosed by it; together
+   they determine the loop, since the sequence is fixed */
+static uint64_t
+loop_key(const short *pt,
+	 const int i)
+{
+  int k,j = (i == 0) ? pt[0]+1 : pt[i];
+  uint64_t h = ((uint64_t)i << 32) | (uint64_t)j;
+
+#define MIX64(x) ((x) ^= (x) >> 31, (x) *= 0x7fb5d329728ea185ULL,	\
+		  (x) ^= (x) >> 27, (x) *= 0x81dadef4bc2dd44dULL, (x) ^= (x) >> 33)
+  MIX64(h);
+  for(k=i+1;k<j;k++){
+    if (pt[k] > k){
+      h ^= ((uint64_t)k << 32) | (uint64_t)pt[k];
+      MIX64(h);
+      k = pt[k];
+    }
+  }
+#undef MIX64
+  return (h == 0) ? 1 : h;
+}
@@ -0,0 +1,31 @@
+/*  Last changed Time-stamp: <2026-10-19 16:02:44 mtw> */
+
+#ifndef WL_LOOPTREE_H
+#define WL_LOOPTREE_H
+
+#include "wl_rna.h"
+#include "wl_loopcache.h"
+
+/* loop decomposition of the current structure; each loop is
+   identified by the 5' position of its closing pair (0: exterior
+   loop) */
+typedef struct _looptree {
+  int n;            /* sequence length */
+  short *parent;    /* loop each position belongs to; paired positions
+		       belong to the loop enclosing their pair */
+  int *energy;      /* energy of each loop (dcal/mol) */
+  short *stack;     /* scratch space for looptree_init() */
+  int mi,mj;        /* last move evaluated ... */
+  int ep,ei;        /* ... and new energies of the loops it affects */
+  long int evals;   /* # of loop evaluations performed */
+  loopcache *cache; /* loop energies seen before (NULL: off); may
+		       be shared between trees */
+} looptree;
+
+looptree *looptree_init(vrna_fold_compound_t *, short *, loopcache *);
+int looptree_eval_move(looptree *, vrna_fold_compound_t *, short *, const int, const int);
+void looptree_apply_move(looptree *, vrna_fold_compound_t *, short *, const int, const int);
+int looptree_energy(const looptree *);
+void looptree_free(looptree *);
+
+#endif
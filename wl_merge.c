@@ -0,0 +1,232 @@
+/*
+  wl_merge.c : merge the (log) DOS estimates of RNAwl runs on
+               overlapping energy windows (--elow/--ehigh) into one DOS
+  Last changed Time-stamp: <2026-10-19 14:05:12 mtw>
+
+  Each window knows ln g only up to an additive constant. Adjacent
+  windows are aligned by the constant that minimizes the squared
+  difference of ln g over their overlap, the first bins at either
+  window edge are left out since WL is biased there (Schulz et al.
+  2003). The merged DOS is normalized with the exact number of
+  structures in its lowest bin, as computed by subopt.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "config.h"
+#include "wl_dosfile.h"
+#include "wl_rna.h"
+#include "wl_merge_cmdline.h"
+
+#define MIN2(A, B)  ((A) < (B) ? (A) : (B))
+#define MAX2(A, B)  ((A) > (B) ? (A) : (B))
+#define LINELEN 10000
+
+static struct gengetopt_args_info args_info;
+
+static int by_energy(const void *, const void *);
+static char *read_sequence(const char *);
+static double count_lowest_bin(char *, const double, const double, const double);
+
+/* ==== */
+int
+main(int argc, char **argv)
+{
+  int i,k,n,m,trim,cnt;
+  double c,d,dmax,sum,sum2,lo,hi,cut,shift=0.,*offset=NULL;
+  dosfile **win=NULL,*d0=NULL;
+  FILE *fp=NULL;
+
+  if (cmdline_parser (argc, argv, &args_info) != 0){
+    fprintf(stderr, "error while parsing command-line options\n");
+    exit(EXIT_FAILURE);
+  }
+  if ((n = args_info.inputs_num) < 1){
+    fprintf(stderr, "Please provide the .lDoS files of the windows to merge\n");
+    exit(EXIT_FAILURE);
+  }
+  if ((trim = args_info.trim_arg) < 0){
+    fprintf(stderr, "Value of --trim must be >= 0\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /* windows in the order of their lowest energy */
+  win = (dosfile**)calloc(n, sizeof(dosfile*));
+  offset = (double*)calloc(n, sizeof(double));
+  assert(win!=NULL); assert(offset!=NULL);
+  for(k=0;k<n;k++){
+    win[k] = read_dos_file(args_info.inputs[k]);
+  }
+  qsort(win, n, sizeof(dosfile*), by_energy);
+
+  /* align window k to window k-1; the edge bins of both are not used */
+  for(k=1;k<n;k++){
+    d0 = win[k-1];
+    if (d0->n <= 2*trim || win[k]->n <= 2*trim){
+      fprintf(stderr, "window %d has too few bins for --trim %d\n", k, trim);
+      exit(EXIT_FAILURE);
+    }
+    lo = MAX2(d0->e[trim], win[k]->e[trim]);
+    hi = MIN2(d0->e[d0->n-1-trim], win[k]->e[win[k]->n-1-trim]);
+    cnt = 0;
+    sum = 0.;
+    for(i=trim;i<win[k]->n-trim;i++){
+      if (win[k]->e[i] < lo || win[k]->e[i] > hi){ continue; }
+      sum += interpolate_dos(d0, win[k]->e[i]) + offset[k-1] - win[k]->lg[i];
+      cnt++;
+    }
+    if (cnt == 0){
+      fprintf(stderr, "windows %6.2f -- %6.2f and %6.2f -- %6.2f do not overlap\n",
+	      d0->e[0], d0->e[d0->n-1], win[k]->e[0], win[k]->e[win[k]->n-1]);
+      exit(EXIT_FAILURE);
+    }
+    offset[k] = sum/cnt;
+
+    /* consistency of the aligned windows in the overlap */
+    sum2 = 0.;
+    dmax = 0.;
+    for(i=trim;i<win[k]->n-trim;i++){
+      if (win[k]->e[i] < lo || win[k]->e[i] > hi){ continue; }
+      d = win[k]->lg[i] + offset[k] - interpolate_dos(d0, win[k]->e[i]) - offset[k-1];
+      sum2 += d*d;
+      dmax = MAX2(dmax, fabs(d));
+    }
+    printf("# overlap %6.2f -- %6.2f: %3d bins, rms %8.4f, max %8.4f\n",
+	   lo, hi, cnt, sqrt(sum2/cnt), dmax);
+  }
+
+  /* normalize with the exact count in the lowest bin */
+  if (args_info.sequence_given){
+    char *seq = read_sequence(args_info.sequence_arg);
+    if (win[0]->width <= 0.){
+      fprintf(stderr, "cannot determine the bin width of the lowest window\n");
+      exit(EXIT_FAILURE);
+    }
+    c = count_lowest_bin(seq, win[0]->e[0], win[0]->width, args_info.Temp_arg);
+    shift = log(c) - win[0]->lg[0];
+    free(seq);
+  }
+  else {
+    shift = -win[0]->lg[0];
+  }
+
+  /* each window contributes up to the middle of its overlap with the
+     next one */
+  if ((fp = fopen(args_info.output_arg, "w")) == NULL){
+    fprintf(stderr, "Cannot open output file %s\n", args_info.output_arg);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "# DOS merged from %d windows\n", n);
+  for(k=0;k<n;k++){
+    fprintf(fp, "# window %6.2f -- %6.2f: offset %12.6f\n",
+	    win[k]->e[0], win[k]->e[win[k]->n-1], offset[k]);
+  }
+  cut = -INFINITY;
+  for(k=0;k<n;k++){
+    hi = INFINITY;
+    if (k < n-1){
+      m = win[k]->n-1;
+      hi = (MAX2(win[k]->e[0], win[k+1]->e[0]) + MIN2(win[k]->e[m], win[k+1]->e[win[k+1]->n-1]))/2;
+    }
+    for(i=0;i<win[k]->n;i++){
+      if (win[k]->e[i] < cut || win[k]->e[i] >= hi){ continue; }
+      fprintf(fp, "%6.2f\t%20.6f\n", win[k]->e[i], win[k]->lg[i]+offset[k]+shift);
+    }
+    cut = hi;
+  }
+  fclose(fp);
+
+  for(k=0;k<n;k++){
+    free_dos_file(win[k]);
+  }
+  free(win);
+  free(offset);
+  cmdline_parser_free(&args_info);
+  return (EXIT_SUCCESS);
+}
+
+/* ==== */
+static int
+by_energy(const void *a,
+	  const void *b)
+{
+  const dosfile *x = *(const dosfile **)a, *y = *(const dosfile **)b;
+
+  return (x->e[0] > y->e[0]) - (x->e[0] < y->e[0]);
+}
+
+/* ==== */
+/* first line of an RNAwl input file that is not a comment */
+static char *
+read_sequence(const char *fn)
+{
+  char line[LINELEN],*seq=NULL;
+  FILE *fp=NULL;
+
+  if ((fp = fopen(fn, "r")) == NULL){
+    fprintf(stderr, "Cannot open sequence file %s\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  while (fgets(line, LINELEN, fp) != NULL){
+    line[strcspn(line, "\r\n")] = '\0';
+    if (*line == '*' || *line == '\0' || *line == '>'){ continue; }
+    seq = strdup(line);
+    break;
+  }
+  fclose(fp);
+  if (seq == NULL){
+    fprintf(stderr, "No sequence found in %s\n", fn);
+    exit(EXIT_FAILURE);
+  }
+  return seq;
+}
+
+/* ==== */
+/* number of structures of seq with energies in the bin of width w
+   around e, in the energy model of RNAwl (ViennaRNA defaults at
+   temperature T); the bin edges are rebuilt from a midpoint printed
+   with two decimals, hence energies are compared in integer dcal/mol
+   with the edges rounded to the nearest dcal/mol */
+static double
+count_lowest_bin(char *seq,
+		 const double e,
+		 const double w,
+		 const double T)
+{
+  int lo,hi,emfe;
+  double c=0.;
+  vrna_subopt_solution_t *sol=NULL,*p=NULL;
+  vrna_md_t md;
+  vrna_fold_compound_t *vc=NULL;
+
+  lo = (int)floor((e-w/2)*100+0.5);
+  hi = (int)floor((e+w/2)*100+0.5);
+  vrna_md_set_default(&md);
+  md.temperature = T;
+  md.uniq_ML = 1;  /* required by vrna_subopt() */
+  vc = vrna_fold_compound(seq, &md, VRNA_OPTION_MFE);
+  emfe = (int)floor(vrna_mfe(vc, NULL)*100+0.5);
+  if (emfe >= hi){
+    fprintf(stderr, "lowest bin %6.2f -- %6.2f is below the mfe %6.2f\n",
+	    (double)lo/100, (double)hi/100, (double)emfe/100);
+    exit(EXIT_FAILURE);
+  }
+
+  sol = vrna_subopt(vc, hi-emfe, 0, NULL);
+  for (p=sol; p->structure != NULL; p++){
+    int en = (int)floor(p->energy*100+0.5);
+    if (en >= lo && en < hi){ c += 1.; }
+    free(p->structure);
+  }
+  free(sol);
+  vrna_fold_compound_free(vc);
+  if (c == 0.){
+    fprintf(stderr, "lowest bin %6.2f -- %6.2f contains no structure\n",
+	    (double)lo/100, (double)hi/100);
+    exit(EXIT_FAILURE);
+  }
+  return c;
+}
@@ -0,0 +1,160 @@
+/*
+  wl_nfold.c : neighbor list with energy changes for rejection-free
+               (N-fold way) Wang-Landau sampling
+  Last changed Time-stamp: <2026-10-19 15:21:07 mtw>
+
+  Literature:
+  Bortz, AB and Kalos, MH and Lebowitz, JL (1975) J. Comp. Phys. 17:(1) 10-18
+  A new algorithm for Monte Carlo simulation of Ising spin systems
+
+  Schulz, BJ and Binder, K and Mueller, M and Landau, DP (2003)
+  Phys. Rev. E 67:(6) 067102
+  Avoiding boundary effects in Wang-Landau sampling
+*/
+
+/*
+  The energy change of a move only depends on the loop(s) it acts on:
+  inserting (i,j) on the loop enclosing i, deleting (i,j) on the loop
+  closed by (i,j) and the loop enclosing it. After a move, only moves
+  touching the two loops that have changed are evaluated again; all
+  other energy changes are carried over from the previous list.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "wl_nfold.h"
+
+static void loop_parents(nfold *, const short *);
+static int move_cmp(const move_str, const move_str);
+static void reserve(nfold *, const int);
+
+/* ==== */
+nfold *
+nfold_init(vrna_fold_compound_t *vc,
+	   const char *seq,
+	   short *pt)
+{
+  int k;
+  nfold *nf = (nfold*)calloc(1, sizeof(nfold));
+  assert(nf!=NULL);
+
+  nf->parent = (short*)calloc(pt[0]+1, sizeof(short));
+  nf->stack  = (short*)calloc(pt[0]+1, sizeof(short));
+  assert(nf->parent!=NULL); assert(nf->stack!=NULL);
+  loop_parents(nf,pt);
+
+  nf->n = get_all_moves_pt(seq,pt,&nf->mv);
+  reserve(nf,nf->n);
+  for(k=0;k<nf->n;k++){
+    nf->de[k] = vrna_eval_move_pt(vc,pt,nf->mv[k].left,nf->mv[k].right);
+  }
+  nf->evals = nf->n;
+  return nf;
+}
+
+/* ==== */
+/* update the neighbor list after move m has been applied to pt */
+void
+nfold_update(nfold *nf,
+	     vrna_fold_compound_t *vc,
+	     const char *seq,
+	     short *pt,
+	     const move_str m)
+{
+  int k,o,c,a,n,l1,l2,*de=NULL;
+  move_str *mv=NULL;
+
+  loop_parents(nf,pt);
+  /* loops that have changed: the one closed by the (former) pair and
+     the one enclosing it */
+  l1 = abs(m.left);
+  l2 = nf->parent[l1];
+
+  n = get_all_moves_pt(seq,pt,&mv);
+  de = (int*)calloc(n+1, sizeof(int));
+  assert(de!=NULL);
+  for(k=0,o=0;k<n;k++){
+    a = abs(mv[k].left);
+    while (o < nf->n && (c = move_cmp(nf->mv[o],mv[k])) < 0){ o++; }
+    if (o < nf->n && c == 0){
+      int changed;
+      if (mv[k].left > 0){ /* insertion */
+	changed = (nf->parent[a] == l1 || nf->parent[a] == l2);
+      }
+      else {               /* deletion */
+	changed = (a == l1 || a == l2 ||
+		   nf->parent[a] == l1 || nf->parent[a] == l2);
+      }
+      if (!changed){
+	de[k] = nf->de[o];
+	continue;
+      }
+    }
+    de[k] = vrna_eval_move_pt(vc,pt,mv[k].left,mv[k].right);
+    nf->evals++;
+  }
+
+  free(nf->mv);
+  free(nf->de);
+  nf->mv = mv;
+  nf->de = de;
+  nf->n  = n;
+  reserve(nf,n);
+}
+
+/* ==== */
+void
+nfold_free(nfold *nf)
+{
+  if (nf == NULL){ return; }
+  free(nf->mv);
+  free(nf->de);
+  free(nf->w);
+  free(nf->bin);
+  free(nf->parent);
+  free(nf->stack);
+  free(nf);
+}
+
+/* ==== */
+/* innermost pair (opening position) enclosing each position; for a
+   paired position, the pair enclosing its pair */
+static void
+loop_parents(nfold *nf,
+	     const short *pt)
+{
+  int k,top=0;
+
+  for(k=1;k<=pt[0];k++){
+    if (pt[k] != 0 && pt[k] < k){ top--; }  /* closing a pair */
+    nf->parent[k] = (top > 0) ? nf->stack[top-1] : 0;
+    if (pt[k] > k){ nf->stack[top++] = k; } /* opening a pair */
+  }
+}
+
+/* ==== */
+/* order of moves as generated by get_all_moves_pt() */
+static int
+move_cmp(const move_str a,
+	 const move_str b)
+{
+  int x;
+
+  if ((x = abs(a.left) - abs(b.left)) != 0){ return x; }
+  if ((x = abs(a.right) - abs(b.right)) != 0){ return x; }
+  return (a.left > 0) - (b.left > 0);
+}
+
+/* ==== */
+static void
+reserve(nfold *nf,
+	const int n)
+{
+  nf->nalloc = n+1;
+  nf->de  = (int*)realloc(nf->de, nf->nalloc*sizeof(int));
+  nf->w   = (double*)realloc(nf->w, nf->nalloc*sizeof(double));
+  nf->bin = (size_t*)realloc(nf->bin, nf->nalloc*sizeof(size_t));
+  assert(nf->de!=NULL); assert(nf->w!=NULL); assert(nf->bin!=NULL);
+}
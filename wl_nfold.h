@@ -0,0 +1,28 @@
+/*  Last changed Time-stamp: <2026-10-19 15:21:07 mtw> */
+
+#ifndef WL_NFOLD_H
+#define WL_NFOLD_H
+
+#include <stddef.h>
+#include "wl_rna.h"
+#include "moves.h"
+
+/* all neighbors of the current structure and their energy changes */
+typedef struct _nfold {
+  int n;            /* # of neighbors */
+  int nalloc;       /* allocated entries of de, w and bin */
+  move_str *mv;     /* moves to the neighbors, ordered by position */
+  int *de;          /* energy change of each move (dcal/mol) */
+  double *w;        /* acceptance weight of each move */
+  size_t *bin;      /* histogram bin of each neighbor */
+  short *parent;    /* innermost pair enclosing each position (0:
+		       exterior loop) */
+  short *stack;     /* scratch space for loop_parents() */
+  long int evals;   /* # of move evaluations performed */
+} nfold;
+
+nfold *nfold_init(vrna_fold_compound_t *, const char *, short *);
+void nfold_update(nfold *, vrna_fold_compound_t *, const char *, short *, const move_str);
+void nfold_free(nfold *);
+
+#endif
@@ -0,0 +1,216 @@
+/*
+  wl_observe.c : per-bin averages of structural observables, collected
+                 in a multicanonical production run with fixed ln g
+  Last changed Time-stamp: <2026-10-19 21:02:37 mtw>
+
+  Means and variances are updated in one pass (Welford), s.t. long runs
+  neither overflow nor lose precision. With the DOS, the averages of a
+  bin are reweighted to canonical averages at any temperature,
+  <O>(T) = sum_E g(E) exp(-E/kT) <O>_E / Z(T).
+
+  Literature:
+  Welford, BP (1962) Technometrics 4:419-420: Note on a method for
+  calculating corrected sums of squares and products
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_observe.h"
+#include "wl_thermo.h"
+
+static const char *obs_name[NOBS] = {"pairs", "helices", "distance"};
+
+/* ==== */
+/* accumulators for nb bins and a sequence of length n */
+observables *
+observables_init(const int nb,
+		 const int n)
+{
+  observables *o = (observables*)calloc(1, sizeof(observables));
+  assert(o!=NULL);
+  o->nb = nb;
+  o->n = n;
+  o->cnt = (double*)calloc(nb, sizeof(double));
+  o->mean = (double*)calloc((size_t)nb*NOBS, sizeof(double));
+  o->m2 = (double*)calloc((size_t)nb*NOBS, sizeof(double));
+  o->paired = (double*)calloc((size_t)nb*n, sizeof(double));
+  assert(o->cnt!=NULL); assert(o->mean!=NULL);
+  assert(o->m2!=NULL); assert(o->paired!=NULL);
+  return o;
+}
+
+/* ==== */
+/* add accumulators for bins appended at the high end */
+void
+observables_resize(observables *o,
+		   const int nb)
+{
+  const int old = o->nb;
+
+  if (nb <= old){ return; }
+  o->cnt = (double*)realloc(o->cnt, nb*sizeof(double));
+  o->mean = (double*)realloc(o->mean, (size_t)nb*NOBS*sizeof(double));
+  o->m2 = (double*)realloc(o->m2, (size_t)nb*NOBS*sizeof(double));
+  o->paired = (double*)realloc(o->paired, (size_t)nb*o->n*sizeof(double));
+  assert(o->cnt!=NULL); assert(o->mean!=NULL);
+  assert(o->m2!=NULL); assert(o->paired!=NULL);
+  memset(o->cnt+old, 0, (nb-old)*sizeof(double));
+  memset(o->mean+(size_t)old*NOBS, 0, (size_t)(nb-old)*NOBS*sizeof(double));
+  memset(o->m2+(size_t)old*NOBS, 0, (size_t)(nb-old)*NOBS*sizeof(double));
+  memset(o->paired+(size_t)old*o->n, 0, (size_t)(nb-old)*o->n*sizeof(double));
+  o->nb = nb;
+}
+
+/* ==== */
+/* one sample in bin b: observables x[0..NOBS-1] of the structure pt */
+void
+observables_add(observables *o,
+		const int b,
+		const double *x,
+		const short *pt)
+{
+  int k,i;
+  double d,*mean = o->mean + (size_t)b*NOBS,*m2 = o->m2 + (size_t)b*NOBS;
+  double *p = o->paired + (size_t)b*o->n - 1;
+  const double c = (o->cnt[b] += 1.);
+
+  for(k=0;k<NOBS;k++){
+    d = x[k] - mean[k];
+    mean[k] += d/c;
+    m2[k] += d*(x[k] - mean[k]);
+  }
+  for(i=1;i<=o->n;i++){
+    p[i] += (pt[i] != 0);
+  }
+}
+
+/* ==== */
+/* observables of structure pt: # of base pairs, # of helices (maximal
+   stacks of pairs) and base-pair distance to ref */
+void
+observables_structure(const short *pt,
+		      const short *ref,
+		      double *x)
+{
+  int i,np=0,nh=0,d=0;
+  const int n = pt[0];
+
+  for(i=1;i<=n;i++){
+    if (pt[i] != ref[i]){
+      if (pt[i] > i){ d++; }
+      if (ref[i] > i){ d++; }
+    }
+    if (pt[i] <= i){ continue; }
+    np++;
+    /* (i,j) starts a helix unless (i-1,j+1) is a pair */
+    if (i == 1 || pt[i] == n || pt[i-1] != pt[i]+1){ nh++; }
+  }
+  x[0] = np;
+  x[1] = nh;
+  x[2] = d;
+}
+
+/* ==== */
+/* mean and standard deviation of each observable per populated bin
+   with edges range[] */
+void
+observables_fprintf(FILE *fp,
+		    const observables *o,
+		    const double *range)
+{
+  int b,k;
+
+  fprintf(fp, "# %6s %12s", "energy", "samples");
+  for(k=0;k<NOBS;k++){
+    fprintf(fp, " %10s %10s", obs_name[k], "sd");
+  }
+  fprintf(fp, "\n");
+  for(b=0;b<o->nb;b++){
+    if (o->cnt[b] == 0.){ continue; }
+    fprintf(fp, "%8.2f %12.0f", (range[b]+range[b+1])/2, o->cnt[b]);
+    for(k=0;k<NOBS;k++){
+      fprintf(fp, " %10.4f %10.4f", o->mean[(size_t)b*NOBS+k],
+	      (o->cnt[b] > 1.) ? sqrt(o->m2[(size_t)b*NOBS+k]/(o->cnt[b]-1.)) : 0.);
+    }
+    fprintf(fp, "\n");
+  }
+}
+
+/* ==== */
+/* probability of each nucleotide to be paired, per populated bin */
+void
+observables_fprintf_pairing(FILE *fp,
+			    const observables *o,
+			    const double *range)
+{
+  int b,i;
+
+  fprintf(fp, "# energy, then the pairing probability of nucleotides 1..%d\n",o->n);
+  for(b=0;b<o->nb;b++){
+    if (o->cnt[b] == 0.){ continue; }
+    fprintf(fp, "%8.2f", (range[b]+range[b+1])/2);
+    for(i=0;i<o->n;i++){
+      fprintf(fp, " %6.4f", o->paired[(size_t)b*o->n+i]/o->cnt[b]);
+    }
+    fprintf(fp, "\n");
+  }
+}
+
+/* ==== */
+/* canonical averages at the nt temperatures T (Celsius), reweighted
+   with ln g on the bins with edges range[]; bins without samples are
+   left out */
+void
+observables_canonical(FILE *fp,
+		      const observables *o,
+		      const double *range,
+		      const double *lg,
+		      const double *T,
+		      const int nt)
+{
+  int b,k,t;
+  double beta,e,x,m,z,avg[NOBS];
+
+  fprintf(fp, "# %8s", "T[C]");
+  for(k=0;k<NOBS;k++){
+    fprintf(fp, " %10s", obs_name[k]);
+  }
+  fprintf(fp, "\n");
+  for(t=0;t<nt;t++){
+    beta = 1000./(GASCONST*(T[t]+K0));
+    m = -INFINITY;
+    for(b=0;b<o->nb;b++){
+      if (o->cnt[b] == 0.){ continue; }
+      x = lg[b] - beta*(range[b]+range[b+1])/2;
+      m = (x > m) ? x : m;
+    }
+    z = 0.;
+    for(k=0;k<NOBS;k++){ avg[k] = 0.; }
+    for(b=0;b<o->nb;b++){
+      if (o->cnt[b] == 0.){ continue; }
+      e = exp(lg[b] - beta*(range[b]+range[b+1])/2 - m);
+      z += e;
+      for(k=0;k<NOBS;k++){ avg[k] += e*o->mean[(size_t)b*NOBS+k]; }
+    }
+    fprintf(fp, "%10.2f", T[t]);
+    for(k=0;k<NOBS;k++){
+      fprintf(fp, " %10.4f", (z > 0.) ? avg[k]/z : 0.);
+    }
+    fprintf(fp, "\n");
+  }
+}
+
+/* ==== */
+void
+observables_free(observables *o)
+{
+  if (o == NULL){ return; }
+  free(o->cnt);
+  free(o->mean);
+  free(o->m2);
+  free(o->paired);
+  free(o);
+}
@@ -0,0 +1,30 @@
+/*  Last changed Time-stamp: <2026-10-19 21:02:37 mtw> */
+
+#ifndef WL_OBSERVE_H
+#define WL_OBSERVE_H
+
+#include <stdio.h>
+
+#define NOBS 3      /* base pairs, helices, distance to the mfe */
+
+/* per-bin (microcanonical) averages of structural observables */
+typedef struct _observables {
+  int nb;           /* # of bins */
+  int n;            /* sequence length */
+  double *cnt;      /* # of samples per bin */
+  double *mean;     /* running mean per bin and observable, nb x NOBS */
+  double *m2;       /* sum of squared deviations from it (Welford) */
+  double *paired;   /* # of samples with nucleotide i paired, nb x n */
+} observables;
+
+observables *observables_init(const int, const int);
+void observables_resize(observables *, const int);
+void observables_add(observables *, const int, const double *, const short *);
+void observables_structure(const short *, const short *, double *);
+void observables_fprintf(FILE *, const observables *, const double *);
+void observables_fprintf_pairing(FILE *, const observables *, const double *);
+void observables_canonical(FILE *, const observables *, const double *,
+			   const double *, const double *, const int);
+void observables_free(observables *);
+
+#endif
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <assert.h>
 #include "wl_options.h"
 #include "wl_cmdline.h"
@@ -19,6 +20,9 @@ static void to_basename(char *arg);
 static void parse_infile(FILE *fp);
 
 static struct gengetopt_args_info args_info;
+static const char *range_policy[] = {"abort", "reject", "grow"};
+static const char *norm_policy[] = {"bin", "count", "fit"};
+static const char *dist_ref[] = {"none", "start", "mfe"};
 
 /* ==== */
 void 
@@ -70,8 +74,47 @@ ini_globals(void)
   wanglandau_opt.norm              = 1;
   wanglandau_opt.max               = 99999999999999.;
   wanglandau_opt.max_given         = 0;
+  wanglandau_opt.elow              = 0.;
+  wanglandau_opt.elow_given        = 0;
+  wanglandau_opt.ehigh_given       = 0;
   wanglandau_opt.truedosbins       = 1;
   wanglandau_opt.truedosbins_given = 0;
+  wanglandau_opt.initdos           = NULL;
+  wanglandau_opt.finit             = 1.;
+  wanglandau_opt.autorange         = 0;
+  wanglandau_opt.pilotsteps        = 1e6;
+  wanglandau_opt.normalize         = NORM_BIN;
+  wanglandau_opt.outofrange        = RANGE_GROW;
+  wanglandau_opt.binedges          = NULL;
+  wanglandau_opt.refine            = 0;
+  wanglandau_opt.refinemod         = 1e-3;
+  wanglandau_opt.tmmc              = 0;
+  wanglandau_opt.tmmcbias          = 0;
+  wanglandau_opt.samc              = 0;
+  wanglandau_opt.gamma0            = 1.;
+  wanglandau_opt.t0                = 1e5;
+  wanglandau_opt.nfold             = 0;
+  wanglandau_opt.verify            = 0;
+  wanglandau_opt.exact             = 0;
+  wanglandau_opt.distance          = DIST_NONE;
+  wanglandau_opt.hs                = 0;
+  wanglandau_opt.hres              = 1.;
+  wanglandau_opt.sres              = 3.;
+  wanglandau_opt.production        = 0;
+  wanglandau_opt.reservoir         = 0;
+  wanglandau_opt.loopcache         = 20;
+  wanglandau_opt.statecache        = 20;
+  wanglandau_opt.hll               = 0;
+  wanglandau_opt.walkers           = 1;
+  wanglandau_opt.shareddos         = NULL;
+  wanglandau_opt.refdos            = NULL;
+  wanglandau_opt.target_error      = 0.;
+  wanglandau_opt.tolerance         = 0.;
+  wanglandau_opt.pftol             = 0.;
+  wanglandau_opt.counttol          = 0.;
+  wanglandau_opt.thermo            = NULL;
+  wanglandau_opt.tgrid             = NULL;
+  wanglandau_opt.ntemps            = 0;
   wanglandau_opt.verbose           = 0;
   wanglandau_opt.debug             = 0;
 }
@@ -159,6 +202,319 @@ set_wl_parameters(void)
     }
   }
   
+  if (args_info.init_dos_given){
+    wanglandau_opt.initdos = strdup(args_info.init_dos_arg);
+  }
+
+  if(args_info.init_mod_given){
+    if( (wanglandau_opt.finit = args_info.init_mod_arg) <= wanglandau_opt.ffinal ){
+      fprintf(stderr, "Value of --init-mod must be > value of --mod\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+  
+  if (args_info.auto_given){wanglandau_opt.autorange = 1;}
+
+  if (args_info.pilotsteps_given){
+    if( (wanglandau_opt.pilotsteps = args_info.pilotsteps_arg) <= 0 ){
+      fprintf(stderr, "Value of --pilotsteps must be > 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+  
+  if (args_info.outofrange_given){
+    if (strcmp(args_info.outofrange_arg, "grow") == 0){
+      wanglandau_opt.outofrange = RANGE_GROW;
+    }
+    else if (strcmp(args_info.outofrange_arg, "reject") == 0){
+      wanglandau_opt.outofrange = RANGE_REJECT;
+    }
+    else if (strcmp(args_info.outofrange_arg, "abort") == 0){
+      wanglandau_opt.outofrange = RANGE_ABORT;
+    }
+    else {
+      fprintf(stderr, "Value of --outofrange must be one of grow|reject|abort\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+  
+  if (args_info.normalize_given){
+    if (strcmp(args_info.normalize_arg, "bin") == 0){
+      wanglandau_opt.normalize = NORM_BIN;
+    }
+    else if (strcmp(args_info.normalize_arg, "count") == 0){
+      wanglandau_opt.normalize = NORM_COUNT;
+    }
+    else if (strcmp(args_info.normalize_arg, "fit") == 0){
+      wanglandau_opt.normalize = NORM_FIT;
+    }
+    else {
+      fprintf(stderr, "Value of --normalize must be one of bin|count|fit\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.binedges_given){
+    wanglandau_opt.binedges = strdup(args_info.binedges_arg);
+  }
+
+  /* energy windows: the walk is confined to [elow,ehigh), s.t. runs
+     on adjacent windows can be merged with RNAwl-merge */
+  if (args_info.elow_given){
+    wanglandau_opt.elow = args_info.elow_arg;
+    wanglandau_opt.elow_given = 1;
+    if (wanglandau_opt.binedges != NULL){
+      fprintf(stderr, "--elow cannot be combined with --binedges\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.ehigh_given){
+    if (args_info.max_given){
+      fprintf(stderr, "--ehigh cannot be combined with --max\n");
+      exit (EXIT_FAILURE);
+    }
+    wanglandau_opt.max = args_info.ehigh_arg;
+    wanglandau_opt.max_given = 1;
+    wanglandau_opt.ehigh_given = 1;
+    if (wanglandau_opt.outofrange == RANGE_GROW){
+      if (args_info.outofrange_given){
+	fprintf(stderr, "--ehigh requires --outofrange reject or abort\n");
+	exit (EXIT_FAILURE);
+      }
+      wanglandau_opt.outofrange = RANGE_REJECT;
+    }
+  }
+
+  if (wanglandau_opt.elow_given && wanglandau_opt.max_given &&
+      wanglandau_opt.elow >= wanglandau_opt.max){
+    fprintf(stderr, "Value of --elow must be below --ehigh/--max\n");
+    exit (EXIT_FAILURE);
+  }
+
+  if (args_info.refine_given){
+    if( (wanglandau_opt.refine = args_info.refine_arg) < 0 ||
+	wanglandau_opt.refine > 16){
+      fprintf(stderr, "Value of --refine must be in [0,16]\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.refinemod_given){
+    if( (wanglandau_opt.refinemod = args_info.refinemod_arg) <= 0 ||
+	wanglandau_opt.refinemod >= wanglandau_opt.finit){
+      fprintf(stderr, "Value of --refinemod must be in (0,--init-mod)\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+  
+  if (args_info.tmmc_given){wanglandau_opt.tmmc = 1;}
+  if (args_info.tmmcbias_given){
+    wanglandau_opt.tmmc = 1;
+    wanglandau_opt.tmmcbias = 1;
+  }
+  
+  if (args_info.samc_given){
+    wanglandau_opt.samc = 1;
+    if (wanglandau_opt.refine > 0){
+      fprintf(stderr, "--samc cannot be combined with --refine\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.nfold_given){wanglandau_opt.nfold = 1;}
+  if (args_info.verify_given){wanglandau_opt.verify = 1;}
+  if (args_info.exact_given){wanglandau_opt.exact = 1;}
+
+  if (args_info.loopcache_given){
+    if( (wanglandau_opt.loopcache = args_info.loopcache_arg) < 0 ||
+	wanglandau_opt.loopcache > 30){
+      fprintf(stderr, "Value of --loopcache must be in [0,30]\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.statecache_given){
+    if( (wanglandau_opt.statecache = args_info.statecache_arg) < 0 ||
+	wanglandau_opt.statecache > 30){
+      fprintf(stderr, "Value of --statecache must be in [0,30]\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.hll_given){
+    if( (wanglandau_opt.hll = args_info.hll_arg) != 0 &&
+	(wanglandau_opt.hll < 4 || wanglandau_opt.hll > 16)){
+      fprintf(stderr, "Value of --hll must be 0 or in [4,16]\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.walkers_given){
+    if( (wanglandau_opt.walkers = args_info.walkers_arg) < 1 ){
+      fprintf(stderr, "Value of --walkers must be >= 1\n");
+      exit (EXIT_FAILURE);
+    }
+    if (wanglandau_opt.walkers > 1 && wanglandau_opt.nfold){
+      fprintf(stderr, "--walkers cannot be combined with --nfold\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.shared_dos_given){
+    wanglandau_opt.shareddos = strdup(args_info.shared_dos_arg);
+    /* the shared file has a fixed layout, which every process has to
+       arrive at independently (--auto pilots differ by seed) */
+    if (wanglandau_opt.refine > 0 || wanglandau_opt.samc ||
+	wanglandau_opt.autorange || wanglandau_opt.tmmcbias){
+      fprintf(stderr, "--shared-dos cannot be combined with --refine, --samc, --auto or --tmmcbias\n");
+      exit (EXIT_FAILURE);
+    }
+    if (wanglandau_opt.outofrange == RANGE_GROW){
+      if (args_info.outofrange_given){
+	fprintf(stderr, "--shared-dos requires --outofrange reject or abort\n");
+	exit (EXIT_FAILURE);
+      }
+      wanglandau_opt.outofrange = RANGE_REJECT;
+    }
+  }
+
+  if (args_info.reference_dos_given){
+    wanglandau_opt.refdos = strdup(args_info.reference_dos_arg);
+  }
+
+  if (args_info.target_error_given){
+    if( (wanglandau_opt.target_error = args_info.target_error_arg) <= 0 ){
+      fprintf(stderr, "Value of --target-error must be > 0\n");
+      exit (EXIT_FAILURE);
+    }
+    if (wanglandau_opt.refdos == NULL){
+      fprintf(stderr, "--target-error requires --reference-dos\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.tolerance_given){
+    if( (wanglandau_opt.tolerance = args_info.tolerance_arg) < 0 ){
+      fprintf(stderr, "Value of --tolerance must be >= 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.pf_tolerance_given){
+    if( (wanglandau_opt.pftol = args_info.pf_tolerance_arg) < 0 ){
+      fprintf(stderr, "Value of --pf-tolerance must be >= 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.count_tolerance_given){
+    if( (wanglandau_opt.counttol = args_info.count_tolerance_arg) < 0 ){
+      fprintf(stderr, "Value of --count-tolerance must be >= 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.thermo_given){
+    int k,nv;
+    double from,to,step=1.;
+    nv = sscanf(args_info.thermo_arg, "%lf:%lf:%lf", &from, &to, &step);
+    if (nv == 1){ to = from; }
+    if ((nv != 1 && nv != 3) || step <= 0 || to < from || from < -273.15){
+      fprintf(stderr, "Value of --thermo must be T or from:to:step (Celsius)\n");
+      exit (EXIT_FAILURE);
+    }
+    wanglandau_opt.thermo = strdup(args_info.thermo_arg);
+    wanglandau_opt.ntemps = (int)floor((to-from)/step+1e-9)+1;
+    wanglandau_opt.tgrid = (double*)calloc(wanglandau_opt.ntemps, sizeof(double));
+    assert(wanglandau_opt.tgrid!=NULL);
+    for(k=0;k<wanglandau_opt.ntemps;k++){
+      wanglandau_opt.tgrid[k] = from+k*step;
+    }
+  }
+
+  if (args_info.gamma0_given){
+    if( (wanglandau_opt.gamma0 = args_info.gamma0_arg) <= 0 ){
+      fprintf(stderr, "Value of --gamma0 must be > 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.t0_given){
+    if( (wanglandau_opt.t0 = args_info.t0_arg) < 1 ){
+      fprintf(stderr, "Value of --t0 must be >= 1\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.distance_given){
+    if (strcmp(args_info.distance_arg, "start") == 0){
+      wanglandau_opt.distance = DIST_START;
+    }
+    else if (strcmp(args_info.distance_arg, "mfe") == 0){
+      wanglandau_opt.distance = DIST_MFE;
+    }
+    else {
+      fprintf(stderr, "Value of --distance must be one of start|mfe\n");
+      exit (EXIT_FAILURE);
+    }
+    /* cells are indexed by bin, and ln g lives in the cells */
+    if (wanglandau_opt.refine > 0 || wanglandau_opt.nfold ||
+	wanglandau_opt.shareddos != NULL || wanglandau_opt.tmmcbias ||
+	wanglandau_opt.truedosbins_given){
+      fprintf(stderr, "--distance cannot be combined with --refine, --nfold, --shared-dos, --tmmcbias or --truedosbins\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.hres_given){
+    if( (wanglandau_opt.hres = args_info.hres_arg) <= 0 ){
+      fprintf(stderr, "Value of --hres must be > 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.sres_given){
+    if( (wanglandau_opt.sres = args_info.sres_arg) <= 0 ){
+      fprintf(stderr, "Value of --sres must be > 0\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.hs_given){
+    wanglandau_opt.hs = 1;
+    if (wanglandau_opt.distance != DIST_NONE || wanglandau_opt.refine > 0 ||
+	wanglandau_opt.nfold || wanglandau_opt.shareddos != NULL ||
+	wanglandau_opt.tmmcbias || wanglandau_opt.truedosbins_given){
+      fprintf(stderr, "--hs cannot be combined with --distance, --refine, --nfold, --shared-dos, --tmmcbias or --truedosbins\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.production_given){
+    if( (wanglandau_opt.production = args_info.production_arg) < 0 ){
+      fprintf(stderr, "Value of --production must be >= 0\n");
+      exit (EXIT_FAILURE);
+    }
+    /* samples are not weighted by residence times */
+    if (wanglandau_opt.production > 0 &&
+	(wanglandau_opt.nfold || wanglandau_opt.shareddos != NULL)){
+      fprintf(stderr, "--production cannot be combined with --nfold or --shared-dos\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (args_info.reservoir_given){
+    if( (wanglandau_opt.reservoir = args_info.reservoir_arg) < 0 ){
+      fprintf(stderr, "Value of --reservoir must be >= 0\n");
+      exit (EXIT_FAILURE);
+    }
+    if (wanglandau_opt.reservoir > 0 && wanglandau_opt.nfold){
+      fprintf(stderr, "--reservoir cannot be combined with --nfold\n");
+      exit (EXIT_FAILURE);
+    }
+  }
+  
   if (args_info.verbose_given){wanglandau_opt.verbose = 1;}
   if (args_info.debug_given){wanglandau_opt.debug = 1;}
   
@@ -178,6 +534,8 @@ display_settings(void)
 	  "--bins        = %d\n"
 	  "--checksteps  = %lu\n"
 	  "--max         = %g\n"
+	  "--elow        = %g\n"
+	  "--ehigh       = %g\n"
 	  "--mod         = %g\n"
 	  "--flat        = %g\n"
 	  "--norm        = %d\n"
@@ -186,11 +544,47 @@ display_settings(void)
 	  "--steplimit   = %lu\n"
 	  "--Temp        = %4.2f\n"
 	  "--truedosbins = %i\n"
+	  "--init-dos    = %s\n"
+	  "--init-mod    = %g\n"
+	  "--auto        = %i\n"
+	  "--pilotsteps  = %lu\n"
+	  "--normalize   = %s\n"
+	  "--outofrange  = %s\n"
+	  "--binedges    = %s\n"
+	  "--refine      = %i\n"
+	  "--refinemod   = %g\n"
+	  "--tmmc        = %i\n"
+	  "--tmmcbias    = %i\n"
+	  "--samc        = %i\n"
+	  "--gamma0      = %g\n"
+	  "--t0          = %g\n"
+	  "--nfold       = %i\n"
+	  "--verify      = %i\n"
+	  "--exact       = %i\n"
+	  "--distance    = %s\n"
+	  "--hs          = %i\n"
+	  "--hres        = %g\n"
+	  "--sres        = %g\n"
+	  "--production  = %li\n"
+	  "--reservoir   = %i\n"
+	  "--loopcache   = %i\n"
+	  "--statecache  = %i\n"
+	  "--hll         = %i\n"
+	  "--walkers     = %i\n"
+	  "--shared-dos  = %s\n"
+	  "--reference-dos = %s\n"
+	  "--target-error = %g\n"
+	  "--tolerance   = %g\n"
+	  "--pf-tolerance = %g\n"
+	  "--count-tolerance = %g\n"
+	  "--thermo      = %s\n"
 	  "--verbose     = %i\n"
 	  "--debug       = %i\n",
 	  wanglandau_opt.bins,
 	  wanglandau_opt.checksteps,
 	  wanglandau_opt.max,
+	  wanglandau_opt.elow,
+	  wanglandau_opt.ehigh_given ? wanglandau_opt.max : INFINITY,
 	  wanglandau_opt.ffinal,
 	  wanglandau_opt.flat,
 	  wanglandau_opt.norm,
@@ -199,6 +593,40 @@ display_settings(void)
 	  wanglandau_opt.steplimit,
 	  wanglandau_opt.T,
 	  wanglandau_opt.truedosbins,
+	  (wanglandau_opt.initdos ? wanglandau_opt.initdos : "none"),
+	  wanglandau_opt.finit,
+	  wanglandau_opt.autorange,
+	  wanglandau_opt.pilotsteps,
+	  norm_policy[wanglandau_opt.normalize],
+	  range_policy[wanglandau_opt.outofrange],
+	  (wanglandau_opt.binedges ? wanglandau_opt.binedges : "none"),
+	  wanglandau_opt.refine,
+	  wanglandau_opt.refinemod,
+	  wanglandau_opt.tmmc,
+	  wanglandau_opt.tmmcbias,
+	  wanglandau_opt.samc,
+	  wanglandau_opt.gamma0,
+	  wanglandau_opt.t0,
+	  wanglandau_opt.nfold,
+	  wanglandau_opt.verify,
+	  wanglandau_opt.exact,
+	  dist_ref[wanglandau_opt.distance],
+	  wanglandau_opt.hs,
+	  wanglandau_opt.hres,
+	  wanglandau_opt.sres,
+	  wanglandau_opt.production,
+	  wanglandau_opt.reservoir,
+	  wanglandau_opt.loopcache,
+	  wanglandau_opt.statecache,
+	  wanglandau_opt.hll,
+	  wanglandau_opt.walkers,
+	  (wanglandau_opt.shareddos ? wanglandau_opt.shareddos : "none"),
+	  (wanglandau_opt.refdos ? wanglandau_opt.refdos : "none"),
+	  wanglandau_opt.target_error,
+	  wanglandau_opt.tolerance,
+	  wanglandau_opt.pftol,
+	  wanglandau_opt.counttol,
+	  (wanglandau_opt.thermo ? wanglandau_opt.thermo : "none"),
 	  wanglandau_opt.verbose,
 	  wanglandau_opt.debug);
 }
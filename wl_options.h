@@ -5,6 +5,21 @@
 
 #include <stdio.h>
 
+/* policies for proposed energies above the sampling range */
+#define RANGE_ABORT  0
+#define RANGE_REJECT 1
+#define RANGE_GROW   2
+
+/* normalizations of the scaled DOS */
+#define NORM_BIN     0
+#define NORM_COUNT   1
+#define NORM_FIT     2
+
+/* reference structures of the joint DOS over energy and distance */
+#define DIST_NONE    0
+#define DIST_START   1
+#define DIST_MFE     2
+
 typedef struct _options {
   FILE *INFILE;          /* input file */
   char *basename;        /* base name of processed file */
@@ -24,10 +39,54 @@ typedef struct _options {
   int norm;              /* # of normalization-bins */
   double max;            /* upper energy bound of sampling range */
   int max_given;         /* whether max was given at the command line */
+  double elow;           /* lower limit of the sampling window */
+  int elow_given;        /* whether elow was given at the command line */
+  int ehigh_given;       /* whether ehigh was given at the command line */
   double res;            /* histogram bin width */
   int res_given;         /* whether res was given at the command line */
   int truedosbins;       /* # of bins that get overwritten by true DOS */
   int truedosbins_given; /* whether truedosbins was given */
+  char *initdos;         /* DOS file used as initial estimate */
+  double finit;          /* initial modification parameter f */
+  int autorange;         /* determine range/bins by a pilot run */
+  long int pilotsteps;   /* # of MC steps in pilot run */
+  int normalize;         /* normalization of the scaled DOS */
+  int outofrange;        /* policy for energies >= max */
+  char *binedges;        /* file with histogram bin edges */
+  int refine;            /* # of coarse-to-fine refinement levels */
+  double refinemod;      /* f at which a coarse level is refined */
+  int tmmc;              /* collect transition matrix */
+  int tmmcbias;          /* use TMMC estimate for WL weights */
+  int samc;              /* stochastic approximation MC */
+  double gamma0;         /* initial SAMC gain */
+  double t0;             /* # of SAMC steps with constant gain */
+  int nfold;             /* rejection-free (N-fold way) sampling */
+  int verify;            /* check energies against full evaluation */
+  int exact;             /* exact DOS by dynamic programming */
+  int distance;          /* joint DOS over energy and base-pair
+			    distance to this structure */
+  int hs;                /* joint DOS over enthalpy and entropy */
+  double hres;           /* enthalpy resolution of hs (kcal/mol) */
+  double sres;           /* entropy resolution of hs (cal/(mol K)) */
+  long int production;   /* # of steps with fixed ln g (0: off) */
+  int reservoir;         /* # of structures sampled per bin (0: off) */
+  int loopcache;         /* log2 size of the loop energy cache */
+  int statecache;        /* log2 size of the structure energy cache */
+  int hll;               /* HyperLogLog precision (0: off) */
+  int walkers;           /* # of interleaved walkers */
+  char *shareddos;       /* file holding the shared DOS estimate */
+  char *refdos;          /* reference DOS for error tracking */
+  double target_error;   /* mean relative error that ends the run
+			    (0: off) */
+  double tolerance;      /* max change of ln g between crosschecks
+			    that ends the run (0: off) */
+  double pftol;          /* ensemble free energy deviation that
+			    ends the run (0: off) */
+  double counttol;       /* ln(# structures) deviation that ends the
+			    run (0: off) */
+  char *thermo;          /* temperature grid as given */
+  double *tgrid;         /* temperatures for thermodynamic output */
+  int ntemps;            /* # of temperatures in tgrid */
   int verbose;           /* be verbose */
   int debug;             /* debug mode */
 } options;
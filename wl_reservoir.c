@@ -0,0 +1,176 @@
+/*
+  wl_reservoir.c : per-bin reservoir samples of visited structures
+  Last changed Time-stamp: <2026-10-19 21:48:10 mtw>
+
+  The first k visits of a bin fill its sample; afterwards, the # of
+  visits to skip until the next replacement is drawn from its exact
+  distribution (Algorithm L), s.t. every visit ends up in the sample
+  with the same probability and a random number is only needed per
+  replacement, i.e. O(k log(visits/k)) times per bin.
+
+  Literature:
+  Li, KH (1994) ACM TOMS 20:481-493: Reservoir-sampling algorithms of
+  time complexity O(n(1+log(N/n)))
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_reservoir.h"
+
+static void pack(const reservoir *, uint64_t *, const short *);
+static void unpack(const reservoir *, const uint64_t *, char *);
+static void skip(reservoir *, const int, const gsl_rng *);
+
+/* ==== */
+/* samples of k structures of length n for nb bins */
+reservoir *
+reservoir_init(const int nb,
+	       const int k,
+	       const int n)
+{
+  reservoir *r = (reservoir*)calloc(1, sizeof(reservoir));
+  assert(r!=NULL);
+  r->nb = 0;
+  r->k = k;
+  r->n = n;
+  r->words = (2*n+63)/64;
+  reservoir_resize(r,nb);
+  return r;
+}
+
+/* ==== */
+/* add samples for bins appended at the high end */
+void
+reservoir_resize(reservoir *r,
+		 const int nb)
+{
+  int b;
+  const int old = r->nb;
+  const size_t per = (size_t)r->k*r->words;
+
+  if (nb <= old){ return; }
+  r->seen = (unsigned long*)realloc(r->seen, nb*sizeof(unsigned long));
+  r->next = (unsigned long*)realloc(r->next, nb*sizeof(unsigned long));
+  r->w = (double*)realloc(r->w, nb*sizeof(double));
+  r->e = (int*)realloc(r->e, (size_t)nb*r->k*sizeof(int));
+  r->s = (uint64_t*)realloc(r->s, nb*per*sizeof(uint64_t));
+  assert(r->seen!=NULL); assert(r->next!=NULL); assert(r->w!=NULL);
+  assert(r->e!=NULL); assert(r->s!=NULL);
+  for(b=old;b<nb;b++){
+    r->seen[b] = 0;
+    r->next[b] = 1;  /* the first visits fill the sample */
+    r->w[b] = 1.;
+  }
+  memset(r->s+old*per, 0, (nb-old)*per*sizeof(uint64_t));
+  r->nb = nb;
+}
+
+/* ==== */
+/* the current visit of bin b enters its sample */
+void
+reservoir_take(reservoir *r,
+	       const int b,
+	       const short *pt,
+	       const int e,
+	       const gsl_rng *rng)
+{
+  int j;
+  const unsigned long c = r->seen[b];
+
+  if (c <= (unsigned long)r->k){
+    j = c-1;
+    if (c == (unsigned long)r->k){ skip(r,b,rng); }
+    else { r->next[b] = c+1; }
+  }
+  else {
+    j = gsl_rng_uniform_int(rng,r->k);
+    skip(r,b,rng);
+  }
+  r->e[(size_t)b*r->k+j] = e;
+  pack(r,r->s+((size_t)b*r->k+j)*r->words,pt);
+}
+
+/* ==== */
+/* structures of each populated bin with edges range[] as dot-bracket
+   strings with their energies */
+void
+reservoir_fprintf(FILE *fp,
+		  const reservoir *r,
+		  const double *range)
+{
+  int b,j,m;
+  char *db = (char*)calloc(r->n+1, sizeof(char));
+  assert(db!=NULL);
+
+  for(b=0;b<r->nb;b++){
+    if (r->seen[b] == 0){ continue; }
+    m = (r->seen[b] < (unsigned long)r->k) ? (int)r->seen[b] : r->k;
+    fprintf(fp, "# bin %6.2f -- %6.2f: %lu visits, %d structures\n",
+	    range[b],range[b+1],r->seen[b],m);
+    for(j=0;j<m;j++){
+      unpack(r,r->s+((size_t)b*r->k+j)*r->words,db);
+      fprintf(fp, "%s %6.2f\n",db,(float)r->e[(size_t)b*r->k+j]/100);
+    }
+  }
+  free(db);
+}
+
+/* ==== */
+void
+reservoir_free(reservoir *r)
+{
+  if (r == NULL){ return; }
+  free(r->seen);
+  free(r->next);
+  free(r->w);
+  free(r->e);
+  free(r->s);
+  free(r);
+}
+
+/* ==== */
+/* draw the next visit of bin b that replaces a sampled one */
+static void
+skip(reservoir *r,
+     const int b,
+     const gsl_rng *rng)
+{
+  r->w[b] *= exp(log(gsl_rng_uniform_pos(rng))/r->k);
+  r->next[b] = r->seen[b] + 1 +
+    (unsigned long)floor(log(gsl_rng_uniform_pos(rng))/log1p(-r->w[b]));
+}
+
+/* ==== */
+/* 2 bits per position: 0 unpaired, 1 opening, 2 closing */
+static void
+pack(const reservoir *r,
+     uint64_t *dst,
+     const short *pt)
+{
+  int i;
+  uint64_t v;
+
+  memset(dst, 0, r->words*sizeof(uint64_t));
+  for(i=1;i<=r->n;i++){
+    v = (pt[i] == 0) ? 0 : ((pt[i] > i) ? 1 : 2);
+    dst[(2*(i-1))/64] |= v << ((2*(i-1))%64);
+  }
+}
+
+/* ==== */
+static void
+unpack(const reservoir *r,
+       const uint64_t *src,
+       char *db)
+{
+  int i;
+  static const char sym[4] = {'.', '(', ')', '?'};
+
+  for(i=0;i<r->n;i++){
+    db[i] = sym[(src[(2*i)/64] >> ((2*i)%64)) & 3];
+  }
+  db[r->n] = '\0';
+}
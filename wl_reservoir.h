@@ -0,0 +1,44 @@
+/*  Last changed Time-stamp: <2026-10-19 21:48:10 mtw> */
+
+#ifndef WL_RESERVOIR_H
+#define WL_RESERVOIR_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <gsl/gsl_rng.h>
+
+/* uniform random sample of fixed size of the structures visited in
+   each bin; structures are packed with 2 bits per nucleotide */
+typedef struct _reservoir {
+  int nb;           /* # of bins */
+  int k;            /* # of structures kept per bin */
+  int n;            /* sequence length */
+  int words;        /* 64-bit words per packed structure */
+  unsigned long *seen; /* # of visits per bin */
+  unsigned long *next; /* visit that enters the sample next */
+  double *w;        /* skip distribution parameter per bin */
+  int *e;           /* energies (dcal/mol), nb x k */
+  uint64_t *s;      /* packed structures, nb x k x words */
+} reservoir;
+
+reservoir *reservoir_init(const int, const int, const int);
+void reservoir_resize(reservoir *, const int);
+void reservoir_take(reservoir *, const int, const short *, const int, const gsl_rng *);
+void reservoir_fprintf(FILE *, const reservoir *, const double *);
+void reservoir_free(reservoir *);
+
+/* ==== */
+/* visit of structure pt with energy e in bin b; most visits are
+   skipped without drawing a random number */
+static inline void
+reservoir_add(reservoir *r,
+	      const int b,
+	      const short *pt,
+	      const int e,
+	      const gsl_rng *rng)
+{
+  if (++r->seen[b] < r->next[b]){ return; }
+  reservoir_take(r,b,pt,e,rng);
+}
+
+#endif
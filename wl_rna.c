@@ -41,6 +41,48 @@ pre_process_RNA(void)
   subopt_of_lowest_bins_RNA(wanglandau_opt.erange); 
 }
 
+/* ==== */
+/* exact ensemble free energy -kT ln Z (kcal/mol) of seq at the
+   simulation temperature */
+double
+ensemble_energy_RNA(const char *seq)
+{
+  double G,emin;
+  vrna_md_t md;
+  vrna_fold_compound_t *vc=NULL;
+
+  vrna_md_set_default(&md);
+  md.temperature = wanglandau_opt.T;
+  md.compute_bpp = 0;
+  vc = vrna_fold_compound(seq, &md, VRNA_OPTION_MFE|VRNA_OPTION_PF);
+  emin = (double)vrna_mfe(vc,NULL);
+  vrna_exp_params_rescale(vc,&emin); /* avoid overflow of Z */
+  G = (double)vrna_pf(vc,NULL);
+  vrna_fold_compound_free(vc);
+  if(wanglandau_opt.verbose){
+    fprintf(stderr,"ensemble free energy = %6.2f\n",G);
+  }
+  return G;
+}
+
+/* ==== */
+/* mfe structure of seq at the simulation temperature */
+char *
+mfe_structure_RNA(const char *seq)
+{
+  char *s = (char*)calloc(strlen(seq)+1, sizeof(char));
+  vrna_md_t md;
+  vrna_fold_compound_t *vc=NULL;
+
+  assert(s!=NULL);
+  vrna_md_set_default(&md);
+  md.temperature = wanglandau_opt.T;
+  vc = vrna_fold_compound(seq, &md, VRNA_OPTION_MFE);
+  (void) vrna_mfe(vc,s);
+  vrna_fold_compound_free(vc);
+  return s;
+}
+
 /* ==== */
 void
 post_process_RNA(void)
@@ -74,7 +116,7 @@ subopt_of_lowest_bins_RNA(float e)
     }
     if (i == 0){have_lowest_bin=1;}
     if (wanglandau_opt.verbose){
-      printf("%s %6.2f %d\n",sol[strucs].structure,sol[strucs].energy,i);
+      printf("%s %6.2f %zu\n",sol[strucs].structure,sol[strucs].energy,i);
     }
     gsl_histogram_increment(s,sol[strucs].energy);
     free(sol[strucs].structure);
@@ -95,7 +137,7 @@ subopt_of_lowest_bins_RNA(float e)
 	    "histogram s (first bin required for normalization)\n");
     for(i=0;i<wanglandau_opt.truedosbins;i++){
       double value = gsl_histogram_get(s,i);
-      fprintf(stderr,"s[%d]: %7g\n",i,value);
+      fprintf(stderr,"s[%zu]: %7g\n",i,value);
     }
   }
     
@@ -13,11 +13,14 @@
 #include <ViennaRNA/structure_utils.h>
 #include <ViennaRNA/move_set.h>
 #include <ViennaRNA/subopt.h>
+#include <ViennaRNA/part_func.h>
 
 
 /* RNA-related */
 void initialize_RNA(const char *);
 void pre_process_RNA(void);
 void post_process_RNA(void);
+double ensemble_energy_RNA(const char *);
+char *mfe_structure_RNA(const char *);
 
 #endif
@@ -0,0 +1,239 @@
+/*
+  wl_shared.c : DOS estimate shared by several RNAwl processes through
+                a memory-mapped file
+  Last changed Time-stamp: <2026-10-19 18:31:55 mtw>
+*/
+
+/*
+  The first process creates the file and copies its initial ln g into
+  it; later processes attach to it and continue from its current
+  state. All processes add to ln g and h atomically. Flatness checks
+  are done by one process at a time (the leader); a leader that died
+  is replaced by the next process that wants to check. Processes that
+  die just stop contributing.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "wl_shared.h"
+
+#define SHARED_MAGIC 0x524e41776c444f53ULL /* "RNAwlDOS" */
+
+static void attach_bins(shared_dos *, gsl_histogram *, gsl_histogram *);
+static int claim(int32_t *);
+
+/* ==== */
+/* attach the histograms g and h (and lnf) to the shared DOS in file
+   fn, creating it from g, h and lnf if it does not exist */
+shared_dos *
+shared_dos_open(const char *fn,
+		gsl_histogram *g,
+		gsl_histogram *h,
+		double *lnf)
+{
+  int k,creator=1;
+  struct stat st;
+  shared_dos *sd = (shared_dos*)calloc(1, sizeof(shared_dos));
+  assert(sd!=NULL);
+
+  sd->size = sizeof(shared_hdr) + 2*g->n*sizeof(double);
+  if ((sd->fd = open(fn, O_RDWR|O_CREAT|O_EXCL, 0644)) == -1){
+    if (errno != EEXIST || (sd->fd = open(fn, O_RDWR)) == -1){
+      fprintf(stderr,"Cannot open shared DOS file %s: %s\n",fn,strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+    creator = 0;
+  }
+  if (creator){
+    if (ftruncate(sd->fd, sd->size) == -1){
+      fprintf(stderr,"Cannot resize shared DOS file %s: %s\n",fn,strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+  }
+  else { /* wait until the creator has set the file up */
+    st.st_size = 0;
+    for(k=0;k<1000;k++){
+      if (fstat(sd->fd,&st) == 0 && (size_t)st.st_size >= sizeof(shared_hdr)){ break; }
+      usleep(10000);
+    }
+    if ((size_t)st.st_size != sd->size){
+      fprintf(stderr,"Shared DOS file %s does not match the current histogram layout (%d bins)\n",
+	      fn,(int)g->n);
+      exit(EXIT_FAILURE);
+    }
+  }
+  sd->hdr = (shared_hdr*)mmap(NULL, sd->size, PROT_READ|PROT_WRITE, MAP_SHARED, sd->fd, 0);
+  if (sd->hdr == MAP_FAILED){
+    fprintf(stderr,"Cannot map shared DOS file %s: %s\n",fn,strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  sd->g = (double*)(sd->hdr+1);
+  sd->h = sd->g + g->n;
+
+  if (creator){
+    sd->hdr->magic = SHARED_MAGIC;
+    sd->hdr->n = g->n;
+    sd->hdr->lo = g->range[0];
+    sd->hdr->hi = g->range[g->n];
+    sd->hdr->lnf = *lnf;
+    sd->hdr->writer = (int32_t)getpid();
+    memcpy(sd->g, g->bin, g->n*sizeof(double));
+    memcpy(sd->h, h->bin, h->n*sizeof(double));
+    __atomic_store_n(&sd->hdr->ready, 1, __ATOMIC_RELEASE);
+  }
+  else {
+    for(k=0;k<1000 && !__atomic_load_n(&sd->hdr->ready, __ATOMIC_ACQUIRE);k++){
+      usleep(10000);
+    }
+    if (sd->hdr->magic != SHARED_MAGIC || !sd->hdr->ready || sd->hdr->n != (int)g->n ||
+	sd->hdr->lo != g->range[0] || sd->hdr->hi != g->range[g->n]){
+      fprintf(stderr,"Shared DOS file %s does not match the current histogram layout (%d bins, %6.2f -- %6.2f)\n",
+	      fn,(int)g->n,g->range[0],g->range[g->n]);
+      exit(EXIT_FAILURE);
+    }
+    *lnf = shared_dos_lnf(sd);
+  }
+  sd->rank = __atomic_fetch_add(&sd->hdr->workers, 1, __ATOMIC_RELAXED);
+  attach_bins(sd,g,h);
+  fprintf(stderr,"# shared DOS %s: worker %d, f=%g\n",fn,sd->rank,*lnf);
+  return sd;
+}
+
+/* ==== */
+/* become the leader for a flatness check; returns 1 on success */
+int
+shared_dos_lead(shared_dos *sd)
+{
+  return claim(&sd->hdr->leader);
+}
+
+/* ==== */
+/* whether this process writes the crosscheck output; the role passes
+   to the next process that asks once its holder has died */
+int
+shared_dos_writer(shared_dos *sd)
+{
+  return claim(&sd->hdr->writer);
+}
+
+/* ==== */
+void
+shared_dos_unlead(shared_dos *sd)
+{
+  __atomic_store_n(&sd->hdr->leader, 0, __ATOMIC_RELEASE);
+}
+
+/* ==== */
+/* start a new iteration: zero the shared visit histogram with atomic
+   stores, s.t. they do not race with the atomic adds of the other
+   processes (visits added before a bin is zeroed count for the old
+   iteration) */
+void
+shared_dos_reset(shared_dos *sd)
+{
+  int i;
+
+  for(i=0;i<sd->hdr->n;i++){
+    __atomic_store_n((uint64_t*)&sd->h[i], 0, __ATOMIC_RELAXED);
+  }
+}
+
+/* ==== */
+/* current modification factor */
+double
+shared_dos_lnf(const shared_dos *sd)
+{
+  uint64_t u = __atomic_load_n((const uint64_t*)&sd->hdr->lnf, __ATOMIC_ACQUIRE);
+  double lnf;
+
+  memcpy(&lnf,&u,sizeof(double));
+  return lnf;
+}
+
+/* ==== */
+/* publish the reduced modification factor *lnf unless the shared one
+   is already as small (a leader may have started from a stale value);
+   returns 1 if it was published, else sets *lnf to the shared one */
+int
+shared_dos_reduce_lnf(shared_dos *sd,
+		      double *lnf)
+{
+  uint64_t old,new;
+  double cur;
+
+  old = __atomic_load_n((uint64_t*)&sd->hdr->lnf, __ATOMIC_ACQUIRE);
+  memcpy(&new,lnf,sizeof(double));
+  do {
+    memcpy(&cur,&old,sizeof(double));
+    if (cur <= *lnf){
+      *lnf = cur;
+      return 0;
+    }
+  } while (!__atomic_compare_exchange_n((uint64_t*)&sd->hdr->lnf,&old,new,0,
+					__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE));
+  __atomic_fetch_add(&sd->hdr->iterations, 1, __ATOMIC_RELAXED);
+  return 1;
+}
+
+/* ==== */
+/* detach; g and h get their own bins back, holding a copy of the
+   shared state */
+void
+shared_dos_close(shared_dos *sd,
+		 gsl_histogram *g,
+		 gsl_histogram *h)
+{
+  if (sd == NULL){ return; }
+  memcpy(sd->g_own, sd->g, g->n*sizeof(double));
+  memcpy(sd->h_own, sd->h, h->n*sizeof(double));
+  g->bin = sd->g_own;
+  h->bin = sd->h_own;
+  munmap(sd->hdr, sd->size);
+  close(sd->fd);
+  free(sd);
+}
+
+/* ==== */
+/* take the role held by the pid in *slot if it is vacant (0) or its
+   holder has died; returns 1 if this process holds it */
+static int
+claim(int32_t *slot)
+{
+  int32_t none = 0, holder;
+  const int32_t self = (int32_t)getpid();
+
+  if (__atomic_compare_exchange_n(slot,&none,self,0,
+				  __ATOMIC_ACQUIRE,__ATOMIC_RELAXED)){
+    return 1;
+  }
+  holder = none;
+  if (holder == self){ return 1; }
+  if (kill(holder,0) == -1 && errno == ESRCH){
+    /* the holder died */
+    return __atomic_compare_exchange_n(slot,&holder,self,0,
+				       __ATOMIC_ACQUIRE,__ATOMIC_RELAXED);
+  }
+  return 0;
+}
+
+/* ==== */
+/* let g and h operate on the shared bins; their own bins are kept
+   for shared_dos_close(), s.t. gsl_histogram_free() works as usual */
+static void
+attach_bins(shared_dos *sd,
+	    gsl_histogram *g,
+	    gsl_histogram *h)
+{
+  sd->g_own = g->bin;
+  sd->h_own = h->bin;
+  g->bin = sd->g;
+  h->bin = sd->h;
+}
@@ -0,0 +1,60 @@
+/*  Last changed Time-stamp: <2026-10-19 18:31:55 mtw> */
+
+#ifndef WL_SHARED_H
+#define WL_SHARED_H
+
+#include <stdint.h>
+#include <string.h>
+#include <gsl/gsl_histogram.h>
+
+/* header of the shared DOS file; followed by ln g and h (n doubles
+   each) */
+typedef struct _shared_hdr {
+  uint64_t magic;
+  int32_t n;          /* # of bins */
+  int32_t ready;      /* set once the creator has initialized ln g */
+  int32_t workers;    /* # of processes that have attached */
+  int32_t leader;     /* pid of the process checking flatness (0: none) */
+  int32_t writer;     /* pid of the process writing crosscheck output */
+  double lo,hi;       /* sampling range */
+  double lnf;         /* current modification factor */
+  int64_t iterations; /* # of reductions of lnf */
+} shared_hdr;
+
+/* a process's view of the shared DOS */
+typedef struct _shared_dos {
+  int fd;
+  size_t size;        /* size of the mapping */
+  shared_hdr *hdr;
+  double *g,*h;       /* shared ln g and visit histogram */
+  double *g_own,*h_own; /* bins of the process's own histograms */
+  int rank;           /* order of attachment (0: creator) */
+} shared_dos;
+
+shared_dos *shared_dos_open(const char *, gsl_histogram *, gsl_histogram *, double *);
+int shared_dos_lead(shared_dos *);
+void shared_dos_unlead(shared_dos *);
+int shared_dos_writer(shared_dos *);
+void shared_dos_reset(shared_dos *);
+double shared_dos_lnf(const shared_dos *);
+int shared_dos_reduce_lnf(shared_dos *, double *);
+void shared_dos_close(shared_dos *, gsl_histogram *, gsl_histogram *);
+
+/* ==== */
+/* atomic x += v on a double in shared memory */
+static inline void
+shared_add(double *x, const double v)
+{
+  uint64_t old,new;
+  double d;
+
+  old = __atomic_load_n((uint64_t*)x, __ATOMIC_RELAXED);
+  do {
+    memcpy(&d,&old,sizeof(double));
+    d += v;
+    memcpy(&new,&d,sizeof(double));
+  } while (!__atomic_compare_exchange_n((uint64_t*)x,&old,new,1,
+					__ATOMIC_RELAXED,__ATOMIC_RELAXED));
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+  wl_thermo.c : partition function, free energy, mean energy, entropy
+                and heat capacity from a (log) DOS over a temperature
+                grid
+  Last changed Time-stamp: <2026-10-19 18:02:47 mtw>
+
+  All sums are taken as log-sum-exp, i.e. relative to the largest term
+  ln g(E) - E/kT at each temperature, s.t. they do not overflow for
+  long sequences. The loops over temperatures are innermost and free of
+  branches, s.t. the compiler can vectorize them.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_thermo.h"
+
+/* ==== */
+/* n temperatures T[0..n-1] in Celsius */
+thermo *
+thermo_init(const double *T,
+	    const int n)
+{
+  int k;
+  thermo *th = (thermo*)calloc(1, sizeof(thermo));
+  assert(th!=NULL);
+  th->n = n;
+  th->T    = (double*)calloc(n, sizeof(double));
+  th->lnZ  = (double*)calloc(n, sizeof(double));
+  th->F    = (double*)calloc(n, sizeof(double));
+  th->U    = (double*)calloc(n, sizeof(double));
+  th->S    = (double*)calloc(n, sizeof(double));
+  th->C    = (double*)calloc(n, sizeof(double));
+  th->m    = (double*)calloc(n, sizeof(double));
+  th->beta = (double*)calloc(n, sizeof(double));
+  th->z0   = (double*)calloc(n, sizeof(double));
+  th->z1   = (double*)calloc(n, sizeof(double));
+  th->z2   = (double*)calloc(n, sizeof(double));
+  assert(th->T!=NULL); assert(th->lnZ!=NULL); assert(th->F!=NULL);
+  assert(th->U!=NULL); assert(th->S!=NULL); assert(th->C!=NULL);
+  assert(th->m!=NULL); assert(th->beta!=NULL);
+  assert(th->z0!=NULL); assert(th->z1!=NULL); assert(th->z2!=NULL);
+  for(k=0;k<n;k++){
+    th->T[k] = T[k];
+    th->beta[k] = 1000./(GASCONST*(T[k]+K0));  /* 1/kT in mol/kcal */
+  }
+  return th;
+}
+
+/* ==== */
+/* evaluate all quantities from ln g on the n bins with edges
+   range[0..n]; unvisited bins (ln g = 0) are left out, except for the
+   lowest one, where ln g = 0 means a single structure */
+void
+thermo_compute(thermo *th,
+	       const double *range,
+	       const double *lg,
+	       const int n)
+{
+  int i,k;
+  double e,x;
+  const int nt = th->n;
+  const double e0 = (range[0]+range[1])/2; /* energies relative to the
+					      lowest bin, for accuracy */
+
+  for(k=0;k<nt;k++){
+    th->m[k] = -INFINITY;
+    th->z0[k] = th->z1[k] = th->z2[k] = 0.;
+  }
+  /* largest term at each temperature */
+  for(i=0;i<n;i++){
+    if (i > 0 && lg[i] == 0.){ continue; }
+    e = (range[i]+range[i+1])/2 - e0;
+    for(k=0;k<nt;k++){
+      x = lg[i] - th->beta[k]*e;
+      th->m[k] = (x > th->m[k]) ? x : th->m[k];
+    }
+  }
+  /* moments of the Boltzmann weights relative to the largest term */
+  for(i=0;i<n;i++){
+    if (i > 0 && lg[i] == 0.){ continue; }
+    e = (range[i]+range[i+1])/2 - e0;
+    for(k=0;k<nt;k++){
+      x = exp(lg[i] - th->beta[k]*e - th->m[k]);
+      th->z0[k] += x;
+      th->z1[k] += x*e;
+      th->z2[k] += x*e*e;
+    }
+  }
+  for(k=0;k<nt;k++){
+    double u = th->z1[k]/th->z0[k];
+    double var = th->z2[k]/th->z0[k] - u*u;
+    double tk = th->T[k]+K0;
+    th->lnZ[k] = th->m[k] + log(th->z0[k]) - th->beta[k]*e0;
+    th->F[k] = -th->lnZ[k]/th->beta[k];
+    th->U[k] = u + e0;
+    th->S[k] = 1000.*(th->U[k]-th->F[k])/tk;
+    th->C[k] = 1000.*(var > 0. ? var : 0.)*th->beta[k]/tk;
+  }
+}
+
+/* ==== */
+/* the same from a DOS over enthalpy and entropy, i.e. n states (or
+   cells) with enthalpy H (kcal/mol), entropy S (cal/(mol K)) and
+   ln g; the energy at temperature T is H - TS, so U is the mean
+   enthalpy and C follows from its variance */
+void
+thermo_compute_hs(thermo *th,
+		  const double *H,
+		  const double *S,
+		  const double *lg,
+		  const int n)
+{
+  int i,k;
+  double x,h;
+  const int nt = th->n;
+  const double h0 = H[0]; /* enthalpies relative to the first state */
+
+  for(k=0;k<nt;k++){
+    th->m[k] = -INFINITY;
+    th->z0[k] = th->z1[k] = th->z2[k] = 0.;
+  }
+  for(i=0;i<n;i++){
+    for(k=0;k<nt;k++){
+      x = lg[i] - th->beta[k]*(H[i] - (th->T[k]+K0)*S[i]/1000.);
+      th->m[k] = (x > th->m[k]) ? x : th->m[k];
+    }
+  }
+  for(i=0;i<n;i++){
+    h = H[i] - h0;
+    for(k=0;k<nt;k++){
+      x = exp(lg[i] - th->beta[k]*(H[i] - (th->T[k]+K0)*S[i]/1000.) - th->m[k]);
+      th->z0[k] += x;
+      th->z1[k] += x*h;
+      th->z2[k] += x*h*h;
+    }
+  }
+  for(k=0;k<nt;k++){
+    double u = th->z1[k]/th->z0[k];
+    double var = th->z2[k]/th->z0[k] - u*u;
+    double tk = th->T[k]+K0;
+    th->lnZ[k] = th->m[k] + log(th->z0[k]);
+    th->F[k] = -th->lnZ[k]/th->beta[k];
+    th->U[k] = u + h0;
+    th->S[k] = 1000.*(th->U[k]-th->F[k])/tk;
+    th->C[k] = 1000.*(var > 0. ? var : 0.)*th->beta[k]/tk;
+  }
+}
+
+/* ==== */
+void
+thermo_fprintf(FILE *fp,
+	       const thermo *th)
+{
+  int k;
+
+  fprintf(fp, "# %8s %16s %12s %12s %12s %12s\n",
+	  "T[C]", "lnZ", "F[kcal/mol]", "U[kcal/mol]", "S[cal/molK]", "C[cal/molK]");
+  for(k=0;k<th->n;k++){
+    fprintf(fp, "%10.2f %16.6f %12.4f %12.4f %12.4f %12.4f\n",
+	    th->T[k], th->lnZ[k], th->F[k], th->U[k], th->S[k], th->C[k]);
+  }
+}
+
+/* ==== */
+void
+thermo_free(thermo *th)
+{
+  if (th == NULL){ return; }
+  free(th->T);
+  free(th->lnZ);
+  free(th->F);
+  free(th->U);
+  free(th->S);
+  free(th->C);
+  free(th->m);
+  free(th->beta);
+  free(th->z0);
+  free(th->z1);
+  free(th->z2);
+  free(th);
+}
+
+/* ==== */
+/* ln sum_E g(E) exp(-beta E) over the n bins with edges range[0..n]
+   (beta in mol/kcal; beta = 0 gives the total # of structures), with
+   the same treatment of unvisited bins as thermo_compute() */
+double
+dos_log_sum(const double *range,
+	    const double *lg,
+	    const int n,
+	    const double beta)
+{
+  int i;
+  double x,m = -INFINITY,sum = 0.;
+
+  for(i=0;i<n;i++){
+    if (i > 0 && lg[i] == 0.){ continue; }
+    x = lg[i] - beta*(range[i]+range[i+1])/2;
+    m = (x > m) ? x : m;
+  }
+  for(i=0;i<n;i++){
+    if (i > 0 && lg[i] == 0.){ continue; }
+    sum += exp(lg[i] - beta*(range[i]+range[i+1])/2 - m);
+  }
+  return m + log(sum);
+}
@@ -0,0 +1,32 @@
+/*  Last changed Time-stamp: <2026-10-19 18:02:47 mtw> */
+
+#ifndef WL_THERMO_H
+#define WL_THERMO_H
+
+#include <stdio.h>
+
+#define K0 273.15
+#define GASCONST 1.98717  /* cal/(mol K) */
+
+/* thermodynamic quantities from a DOS over a grid of temperatures */
+typedef struct _thermo {
+  int n;            /* # of temperatures */
+  double *T;        /* temperatures (Celsius) */
+  double *lnZ;      /* ln of the partition function */
+  double *F;        /* free energy -kT ln Z (kcal/mol) */
+  double *U;        /* mean energy <E> (kcal/mol) */
+  double *S;        /* entropy (U-F)/T (cal/(mol K)) */
+  double *C;        /* heat capacity var(E)/(kT^2) (cal/(mol K)) */
+  double *m;        /* scratch: max exponent per temperature */
+  double *beta;     /* scratch: 1/kT per temperature */
+  double *z0,*z1,*z2; /* scratch: moments of the Boltzmann weights */
+} thermo;
+
+thermo *thermo_init(const double *, const int);
+void thermo_compute(thermo *, const double *, const double *, const int);
+void thermo_compute_hs(thermo *, const double *, const double *, const double *, const int);
+void thermo_fprintf(FILE *, const thermo *);
+void thermo_free(thermo *);
+double dos_log_sum(const double *, const double *, const int, const double);
+
+#endif
@@ -0,0 +1,234 @@
+/*
+  wl_tmmc.c : transition-matrix Monte Carlo estimate of the DOS from
+              bin-to-bin proposal counts collected during WL sampling
+  Last changed Time-stamp: <2026-10-19 14:03:12 mtw>
+
+  Literature:
+  Wang, JS and Swendsen, RH (2002) J. Stat. Phys. 106:(1) 245-285
+  Transition matrix Monte Carlo method
+
+  Shell, MS and Debenedetti, PG and Panagiotopoulos, AZ (2003)
+  J. Chem. Phys. 119:(18) 9406-9411
+  An improved Monte Carlo method for direct calculation of the density
+  of states
+*/
+
+/*
+  Proposals are drawn uniformly from the N(x) neighbors of structure
+  x. Weighting each proposal x -> y by N(x), C(I,J)/V(I) estimates the
+  mean number of neighbors in bin J of a structure in bin I, hence
+  g(I) C(I,J)/V(I) = g(J) C(J,I)/V(J) (the neighbor relation is
+  symmetric). ln g is obtained from these pairwise ratios by weighted
+  least squares.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "wl_tmmc.h"
+
+#define MAXSWEEPS 10000
+#define TOLERANCE 1e-10
+
+static double count_of(const tmmc *, const int, const int);
+
+/* ==== */
+tmmc *
+tmmc_init(const int n)
+{
+  tmmc *t = (tmmc*)calloc(1, sizeof(tmmc));
+  assert(t!=NULL);
+  tmmc_resize(t,n);
+  return t;
+}
+
+/* ==== */
+/* grow the matrix to n bins; existing counts are kept */
+void
+tmmc_resize(tmmc *t,
+	    const int n)
+{
+  int i;
+
+  if (n <= t->n){ return; }
+  t->len = (int*)realloc(t->len, n*sizeof(int));
+  t->cap = (int*)realloc(t->cap, n*sizeof(int));
+  t->to  = (int**)realloc(t->to, n*sizeof(int*));
+  t->c   = (double**)realloc(t->c, n*sizeof(double*));
+  t->v   = (double*)realloc(t->v, n*sizeof(double));
+  assert(t->len!=NULL); assert(t->cap!=NULL); assert(t->to!=NULL);
+  assert(t->c!=NULL); assert(t->v!=NULL);
+  for(i=t->n;i<n;i++){
+    t->len[i] = t->cap[i] = 0;
+    t->to[i]  = NULL;
+    t->c[i]   = NULL;
+    t->v[i]   = 0.;
+  }
+  t->n = n;
+}
+
+/* ==== */
+/* record a proposal from bin i to bin j by a structure with w
+   neighbors */
+void
+tmmc_update(tmmc *t,
+	    const int i,
+	    const int j,
+	    const double w)
+{
+  t->v[i] += 1.;
+  tmmc_count(t,i,j,w);
+}
+
+/* ==== */
+/* add proposal weight w for i -> j without counting a visit of i */
+void
+tmmc_count(tmmc *t,
+	   const int i,
+	   const int j,
+	   const double w)
+{
+  int k;
+
+  for(k=0;k<t->len[i];k++){
+    if (t->to[i][k] == j){
+      t->c[i][k] += w;
+      return;
+    }
+  }
+  if (t->len[i] == t->cap[i]){
+    t->cap[i] = (t->cap[i] == 0) ? 8 : 2*t->cap[i];
+    t->to[i] = (int*)realloc(t->to[i], t->cap[i]*sizeof(int));
+    t->c[i]  = (double*)realloc(t->c[i], t->cap[i]*sizeof(double));
+    assert(t->to[i]!=NULL); assert(t->c[i]!=NULL);
+  }
+  t->to[i][t->len[i]] = j;
+  t->c[i][t->len[i]]  = w;
+  t->len[i]++;
+}
+
+/* ==== */
+static double
+count_of(const tmmc *t,
+	 const int i,
+	 const int j)
+{
+  int k;
+  for(k=0;k<t->len[i];k++){
+    if (t->to[i][k] == j){ return t->c[i][k]; }
+  }
+  return 0.;
+}
+
+/* ==== */
+/* compute the TMMC estimate of ln g; on input, lg holds the current
+   WL estimate, which anchors the result in the lowest connected
+   bin. Bins not connected to it are set to 0. Returns the # of
+   estimated bins */
+int
+tmmc_estimate(const tmmc *t,
+	      double *lg)
+{
+  int i,j,k,e,ne=0,root=-1,sweep,nest=0;
+  int *deg=NULL,*off=NULL,*adj=NULL,*seen=NULL,*queue=NULL;
+  double cij,cji,sw,sd,maxdiff,val,*d=NULL,*w=NULL;
+  const int n = t->n;
+
+  /* symmetric adjacency (CSR) of bin pairs with counts in both
+     directions */
+  deg = (int*)calloc(n+1, sizeof(int));
+  off = (int*)calloc(n+1, sizeof(int));
+  assert(deg!=NULL); assert(off!=NULL);
+  for(i=0;i<n;i++){
+    for(k=0;k<t->len[i];k++){
+      j = t->to[i][k];
+      if (j != i && count_of(t,j,i) > 0.){ deg[i]++; }
+    }
+  }
+  for(i=0;i<n;i++){ off[i+1] = off[i]+deg[i]; }
+  ne  = off[n];
+  adj = (int*)calloc(ne+1, sizeof(int));
+  d   = (double*)calloc(ne+1, sizeof(double));
+  w   = (double*)calloc(ne+1, sizeof(double));
+  assert(adj!=NULL); assert(d!=NULL); assert(w!=NULL);
+  memset(deg, 0, (n+1)*sizeof(int));
+  for(i=0;i<n;i++){
+    for(k=0;k<t->len[i];k++){
+      j = t->to[i][k];
+      if (j == i || (cji = count_of(t,j,i)) == 0.){ continue; }
+      cij = t->c[i][k];
+      e = off[i]+deg[i]++;
+      adj[e] = j;
+      /* ln g(j) - ln g(i) and its inverse variance */
+      d[e] = log(cij*t->v[j]/(cji*t->v[i]));
+      w[e] = 1./(1./cij + 1./cji);
+    }
+  }
+
+  /* connected component of the lowest visited bin; initial values
+     along a spanning tree */
+  seen  = (int*)calloc(n, sizeof(int));
+  queue = (int*)calloc(n, sizeof(int));
+  assert(seen!=NULL); assert(queue!=NULL);
+  for(i=0;i<n;i++){
+    if (t->v[i] > 0. && off[i+1] > off[i]){ root = i; break; }
+  }
+  if (root >= 0){
+    int head=0,tail=0;
+    seen[root] = 1;
+    queue[tail++] = root;
+    while (head < tail){
+      i = queue[head++];
+      for(e=off[i];e<off[i+1];e++){
+	j = adj[e];
+	if (seen[j]){ continue; }
+	seen[j] = 1;
+	lg[j] = lg[i] + d[e];
+	queue[tail++] = j;
+      }
+    }
+    nest = tail;
+
+    /* Gauss-Seidel sweeps for the weighted least-squares solution */
+    for(sweep=0;sweep<MAXSWEEPS;sweep++){
+      maxdiff = 0.;
+      for(k=1;k<nest;k++){
+	i = queue[k];
+	sw = sd = 0.;
+	for(e=off[i];e<off[i+1];e++){
+	  /* d[e] is ln g(adj) - ln g(i) */
+	  sw += w[e];
+	  sd += w[e]*(lg[adj[e]] - d[e]);
+	}
+	val = sd/sw;
+	maxdiff = fmax(maxdiff, fabs(val-lg[i]));
+	lg[i] = val;
+      }
+      if (maxdiff < TOLERANCE){ break; }
+    }
+  }
+  for(i=0;i<n;i++){
+    if (!seen[i]){ lg[i] = 0.; }
+  }
+
+  free(deg); free(off); free(adj); free(d); free(w);
+  free(seen); free(queue);
+  return nest;
+}
+
+/* ==== */
+void
+tmmc_free(tmmc *t)
+{
+  int i;
+
+  if (t == NULL){ return; }
+  for(i=0;i<t->n;i++){
+    free(t->to[i]);
+    free(t->c[i]);
+  }
+  free(t->len); free(t->cap); free(t->to); free(t->c); free(t->v);
+  free(t);
+}
@@ -0,0 +1,24 @@
+/*  Last changed Time-stamp: <2026-10-19 14:03:12 mtw> */
+
+#ifndef WL_TMMC_H
+#define WL_TMMC_H
+
+/* sparse bin-to-bin proposal counts for transition-matrix MC */
+typedef struct _tmmc {
+  int n;          /* # of bins */
+  int *len;       /* # of distinct target bins per row */
+  int *cap;       /* allocated entries per row */
+  int **to;       /* target bins per row */
+  double **c;     /* proposal counts per row, weighted by the # of
+		     neighbors of the proposing structure */
+  double *v;      /* # of proposals per row */
+} tmmc;
+
+tmmc *tmmc_init(const int);
+void tmmc_resize(tmmc *, const int);
+void tmmc_update(tmmc *, const int, const int, const double);
+void tmmc_count(tmmc *, const int, const int, const double);
+int tmmc_estimate(const tmmc *, double *);
+void tmmc_free(tmmc *);
+
+#endif